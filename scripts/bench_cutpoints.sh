@@ -0,0 +1,106 @@
+#!/bin/bash
+
+# compares the number of cut points and the running time of the analysis when
+# all the loop headers are cut points (--cutpoints loops) and when they are
+# minimized with a feedback vertex set heuristic (--cutpoints fvs)
+
+function usage () {
+echo "
+Usage:
+./bench_cutpoints.sh <OPTION> [FILES]
+
+Runs each file with both selections and prints a CSV line per file:
+file,technique,domain,loops_pr,loops_time,fvs_pr,fvs_time
+where *_pr is the total size of Pr over the analyzed functions
+When no file is given, the C files of ex/ and benchmarks/wcet_base are used.
+
+OPTIONS :
+	-h        : help
+
+	-p        : specify the pagai executable
+	-t        : technique (default lw+pf)
+	-d        : abstract domain (default pk)
+	-a        : additional arguments given to pagai
+	-n        : number of runs per file and mode, the best time is kept (default 3)
+	-T        : time limit per run (default 300s)
+"
+}
+
+PAGAI="pagai"
+TECHNIQUE="lw+pf"
+DOMAIN="pk"
+ARGS=" "
+RUNS=3
+TIME_LIMIT=300
+ROOT=$(dirname $0)/..
+
+while getopts "hp:t:d:a:n:T:" opt ; do
+	case $opt in
+		h)
+			usage
+			exit 1
+			;;
+		p)
+			PAGAI=$OPTARG
+			;;
+		t)
+			TECHNIQUE=$OPTARG
+			;;
+		d)
+			DOMAIN=$OPTARG
+			;;
+		a)
+			ARGS=$OPTARG
+			;;
+		n)
+			RUNS=$OPTARG
+			;;
+		T)
+			TIME_LIMIT=$OPTARG
+			;;
+		?)
+			usage
+			exit
+			;;
+	esac
+done
+shift $((OPTIND-1))
+
+FILES="$@"
+if [ -z "$FILES" ] ; then
+	FILES="$(ls $ROOT/ex/*.c $ROOT/benchmarks/wcet_base/*.c)"
+fi
+
+# total size of Pr, followed by the best wall-clock time in seconds of RUNS
+# executions, or "killed"/"error"
+function run_pagai () {
+	BEST=""
+	for i in $(seq 1 $RUNS) ; do
+		START=$(date +%s.%N)
+		( ulimit -t $TIME_LIMIT ; $PAGAI -i $1 -t $TECHNIQUE -d $DOMAIN --cutpoints $2 --force-old-output $ARGS > $OUTPUT 2>&1 )
+		xs=$?
+		END=$(date +%s.%N)
+		if [ $xs -gt 127 ] ; then
+			echo "killed,killed"
+			return
+		elif [ $xs -ne 0 ] ; then
+			echo "error,error"
+			return
+		fi
+		PR=$(grep "^PR SIZE" $OUTPUT | awk '{s += $3} END {print s+0}')
+		T=$(echo "$END - $START" | bc)
+		if [ -z "$BEST" ] || [ $(echo "$T < $BEST" | bc) -eq 1 ] ; then
+			BEST=$T
+		fi
+	done
+	echo "$PR,$BEST"
+}
+
+OUTPUT=$(mktemp)
+echo "file,technique,domain,loops_pr,loops_time,fvs_pr,fvs_time"
+for FILE in $FILES ; do
+	LOOPS=$(run_pagai $FILE loops)
+	FVS=$(run_pagai $FILE fvs)
+	echo "$FILE,$TECHNIQUE,$DOMAIN,$LOOPS,$FVS"
+done
+rm -f $OUTPUT
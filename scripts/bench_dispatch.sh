@@ -0,0 +1,100 @@
+#!/bin/bash
+
+# compares the running time of the statically dispatched domain kernels
+# (--dispatch static) with the generic virtual interface (--dispatch virtual)
+
+function usage () {
+echo "
+Usage:
+./bench_dispatch.sh <OPTION> [FILES]
+
+Runs each file with both dispatch modes and prints a CSV line per file:
+file,technique,domain,static_time,virtual_time
+When no file is given, the C files of ex/ and benchmarks/wcet_base are used.
+
+OPTIONS :
+	-h        : help
+
+	-p        : specify the pagai executable
+	-t        : technique (default lw+pf)
+	-d        : abstract domain (default pk)
+	-a        : additional arguments given to pagai
+	-n        : number of runs per file and mode, the best time is kept (default 3)
+	-T        : time limit per run (default 300s)
+"
+}
+
+PAGAI="pagai"
+TECHNIQUE="lw+pf"
+DOMAIN="pk"
+ARGS=" "
+RUNS=3
+TIME_LIMIT=300
+ROOT=$(dirname $0)/..
+
+while getopts "hp:t:d:a:n:T:" opt ; do
+	case $opt in
+		h)
+			usage
+			exit 1
+			;;
+		p)
+			PAGAI=$OPTARG
+			;;
+		t)
+			TECHNIQUE=$OPTARG
+			;;
+		d)
+			DOMAIN=$OPTARG
+			;;
+		a)
+			ARGS=$OPTARG
+			;;
+		n)
+			RUNS=$OPTARG
+			;;
+		T)
+			TIME_LIMIT=$OPTARG
+			;;
+		?)
+			usage
+			exit
+			;;
+	esac
+done
+shift $((OPTIND-1))
+
+FILES="$@"
+if [ -z "$FILES" ] ; then
+	FILES="$(ls $ROOT/ex/*.c $ROOT/benchmarks/wcet_base/*.c)"
+fi
+
+# best wall-clock time in seconds of RUNS executions, or "killed"/"error"
+function best_time () {
+	BEST=""
+	for i in $(seq 1 $RUNS) ; do
+		START=$(date +%s.%N)
+		( ulimit -t $TIME_LIMIT ; $PAGAI -i $1 -t $TECHNIQUE -d $DOMAIN --dispatch $2 --quiet -o /dev/null $ARGS > /dev/null 2>&1 )
+		xs=$?
+		END=$(date +%s.%N)
+		if [ $xs -gt 127 ] ; then
+			echo "killed"
+			return
+		elif [ $xs -ne 0 ] ; then
+			echo "error"
+			return
+		fi
+		T=$(echo "$END - $START" | bc)
+		if [ -z "$BEST" ] || [ $(echo "$T < $BEST" | bc) -eq 1 ] ; then
+			BEST=$T
+		fi
+	done
+	echo $BEST
+}
+
+echo "file,technique,domain,static_time,virtual_time"
+for FILE in $FILES ; do
+	STATIC=$(best_time $FILE static)
+	VIRTUAL=$(best_time $FILE virtual)
+	echo "$FILE,$TECHNIQUE,$DOMAIN,$STATIC,$VIRTUAL"
+done
@@ -0,0 +1,192 @@
+#!/usr/bin/python
+
+# measures how pagai scales on the synthetic programs of gen_synthetic.py
+#
+# each series varies one parameter of the programs (number of variables,
+# depth of the loop nest, branches per loop body, states of the automaton)
+# while the others keep their base value, and is run with every technique x
+# domain x solver. Each run gives one CSV line (or JSON object) with the
+# analysis time, the SMT time, the iterations and the peak RSS of pagai.
+#
+# the growth of the time along a series is estimated by the exponent e in
+# time ~ size^e between two consecutive programs, size being the number of
+# lines of the program. A warning is printed when e exceeds --max-exponent.
+
+from __future__ import print_function
+
+import argparse
+import json
+import math
+import os
+import resource
+import subprocess
+import sys
+import time
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+GENERATOR = os.path.join(ROOT, "scripts", "gen_synthetic.py")
+
+FIELDS = ["kind", "param", "vars", "depth", "branches", "states", "lines",
+          "technique", "domain", "solver", "status", "time", "smt_time",
+          "asc_iterations", "desc_iterations", "pr_size", "smt_queries",
+          "peak_rss_kb", "exponent"]
+
+
+def int_list(s):
+    return [int(x) for x in s.split(",") if x]
+
+
+def str_list(s):
+    return [x for x in s.split(",") if x]
+
+
+def series(args):
+    # (kind, varied parameter, list of parameter dicts)
+    base = {"vars": args.base_vars, "depth": args.base_depth,
+            "branches": args.base_branches, "states": 0}
+    res = []
+    for param, values in [("vars", args.vars), ("depth", args.depths),
+                          ("branches", args.branches)]:
+        points = []
+        for v in values:
+            p = dict(base)
+            p[param] = v
+            points.append(p)
+        res.append(("nest", param, points))
+    points = []
+    for s in args.states:
+        points.append({"vars": args.base_vars, "depth": 0, "branches": 0,
+                       "states": s})
+    res.append(("automaton", "states", points))
+    return res
+
+
+def generate(kind, p, directory):
+    if kind == "nest":
+        name = "nest_n%d_d%d_b%d.c" % (p["vars"], p["depth"], p["branches"])
+        opts = ["-n", str(p["vars"]), "-d", str(p["depth"]), "-b", str(p["branches"])]
+    else:
+        name = "automaton_n%d_s%d.c" % (p["vars"], p["states"])
+        opts = ["-n", str(p["vars"]), "-s", str(p["states"])]
+    filename = os.path.join(directory, name)
+    if not os.path.isfile(filename):
+        subprocess.check_call([sys.executable, GENERATOR, kind] + opts + ["-o", filename])
+    with open(filename) as f:
+        lines = len(f.readlines())
+    return filename, lines
+
+
+def parse_output(filename):
+    # sums the statistics printed by --force-old-output over the functions
+    stats = {"time": 0.0, "smt_time": 0.0, "asc_iterations": 0,
+             "desc_iterations": 0, "pr_size": 0, "smt_queries": 0}
+    keys = [("SMT TIME ", "smt_time", float),
+            ("ASC ITERATIONS ", "asc_iterations", int),
+            ("DESC ITERATIONS ", "desc_iterations", int),
+            ("PR SIZE ", "pr_size", int),
+            ("SMT QUERIES ", "smt_queries", int)]
+    with open(filename) as f:
+        for line in f:
+            line = line.strip()
+            if line.endswith(" seconds"):
+                try:
+                    stats["time"] += float(line.split()[0])
+                except ValueError:
+                    pass
+                continue
+            for prefix, key, conv in keys:
+                if line.startswith(prefix):
+                    stats[key] += conv(line[len(prefix):])
+    return stats
+
+
+def run_pagai(args, filename, technique, domain, solver, output):
+    cmd = [args.pagai, "-i", filename, "-t", technique, "-d", domain,
+           "-s", solver, "--force-old-output"] + args.args.split()
+
+    def limit():
+        resource.setrlimit(resource.RLIMIT_CPU, (args.time_limit, args.time_limit))
+
+    with open(output, "w") as out:
+        start = time.time()
+        p = subprocess.Popen(cmd, stdout=out, stderr=subprocess.STDOUT, preexec_fn=limit)
+        # wait4 gives the resource usage of this child only
+        _, status, usage = os.wait4(p.pid, 0)
+        # the child is reaped, Popen must not wait for it again
+        p.returncode = status
+        wall = time.time() - start
+    if os.WIFSIGNALED(status):
+        res = {"status": "killed"}
+    elif os.WEXITSTATUS(status) != 0:
+        res = {"status": "error"}
+    else:
+        res = parse_output(output)
+        res["status"] = "ok"
+        if res["time"] == 0.0:
+            res["time"] = wall
+    # ru_maxrss is in kilobytes on Linux
+    res["peak_rss_kb"] = usage.ru_maxrss
+    return res
+
+
+def main():
+    parser = argparse.ArgumentParser(description="runs pagai on synthetic programs of growing size")
+    parser.add_argument("-p", "--pagai", default="pagai", help="pagai executable")
+    parser.add_argument("-t", "--techniques", type=str_list, default=["lw+pf", "pf", "s"])
+    parser.add_argument("-d", "--domains", type=str_list, default=["box", "pk"])
+    parser.add_argument("-s", "--solvers", type=str_list, default=["z3_api"])
+    parser.add_argument("-a", "--args", default="", help="additional arguments given to pagai")
+    parser.add_argument("--vars", type=int_list, default=[2, 4, 8, 16, 32])
+    parser.add_argument("--depths", type=int_list, default=[1, 2, 3, 4, 5])
+    parser.add_argument("--branches", type=int_list, default=[1, 2, 4, 8, 16])
+    parser.add_argument("--states", type=int_list, default=[8, 16, 32, 64, 128])
+    parser.add_argument("--base-vars", type=int, default=4)
+    parser.add_argument("--base-depth", type=int, default=2)
+    parser.add_argument("--base-branches", type=int, default=2)
+    parser.add_argument("-T", "--time-limit", type=int, default=300, help="CPU time limit per run, in seconds")
+    parser.add_argument("-o", "--output-dir", default="bench-scaling", help="directory of the generated programs")
+    parser.add_argument("-f", "--format", choices=["csv", "json"], default="csv")
+    parser.add_argument("--max-exponent", type=float, default=1.5)
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.output_dir):
+        os.makedirs(args.output_dir)
+    log = os.path.join(args.output_dir, "pagai.log")
+
+    rows = []
+    if args.format == "csv":
+        print(",".join(FIELDS))
+    for kind, param, points in series(args):
+        for technique in args.techniques:
+            for domain in args.domains:
+                for solver in args.solvers:
+                    previous = None
+                    for p in points:
+                        filename, lines = generate(kind, p, args.output_dir)
+                        row = dict(p)
+                        row.update({"kind": kind, "param": param, "lines": lines,
+                                    "technique": technique, "domain": domain,
+                                    "solver": solver, "exponent": ""})
+                        row.update(run_pagai(args, filename, technique, domain, solver, log))
+                        if (row["status"] == "ok" and previous is not None
+                                and previous["time"] > 0.05 and lines > previous["lines"]):
+                            e = (math.log(row["time"] / previous["time"])
+                                 / math.log(float(lines) / previous["lines"]))
+                            row["exponent"] = "%.2f" % e
+                            if e > args.max_exponent:
+                                sys.stderr.write("WARNING: super-linear growth (exponent %.2f) "
+                                                 "for %s %s=%d, %s %s %s\n"
+                                                 % (e, kind, param, p[param], technique, domain, solver))
+                        previous = row if row["status"] == "ok" else None
+                        if args.format == "csv":
+                            print(",".join(str(row.get(k, "")) for k in FIELDS))
+                            sys.stdout.flush()
+                        else:
+                            rows.append(row)
+    if args.format == "json":
+        json.dump(rows, sys.stdout, indent=1)
+        print()
+
+
+if __name__ == "__main__":
+    main()
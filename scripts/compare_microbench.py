@@ -0,0 +1,70 @@
+#!/usr/bin/python
+
+# compares two JSON outputs of pagai-microbench (-o file.json)
+#
+# for each benchmark present in both files, prints the median times and their
+# ratio current / baseline. A benchmark whose median grows by more than
+# --threshold is a regression, and the script then exits with status 1.
+# The medians below --min-ns are too noisy to be compared, and are never
+# reported as regressions.
+
+from __future__ import print_function
+
+import argparse
+import json
+import sys
+
+
+def load(filename):
+    with open(filename) as f:
+        data = json.load(f)
+    benchmarks = {}
+    for b in data["benchmarks"]:
+        benchmarks[b["name"]] = b
+    return data, benchmarks
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compares two results of pagai-microbench")
+    parser.add_argument("baseline", help="JSON results used as reference")
+    parser.add_argument("current", help="JSON results to compare with the baseline")
+    parser.add_argument("-t", "--threshold", type=float, default=0.10,
+                        help="relative slowdown of the median reported as a regression (default 0.10)")
+    parser.add_argument("--min-ns", type=float, default=1000,
+                        help="medians below this time are not compared (default 1000 ns)")
+    args = parser.parse_args()
+
+    base_data, base = load(args.baseline)
+    cur_data, cur = load(args.current)
+
+    for key in ["vars", "branches"]:
+        if base_data.get(key) != cur_data.get(key):
+            print("WARNING: the results were not obtained with the same --%s (%s, %s)"
+                  % (key, base_data.get(key), cur_data.get(key)))
+
+    regressions = 0
+    print("%-56s %12s %12s %7s" % ("benchmark", "baseline", "current", "ratio"))
+    for name in sorted(set(base) & set(cur)):
+        b = base[name]["median_ns"]
+        c = cur[name]["median_ns"]
+        ratio = c / b if b > 0 else float("inf")
+        status = ""
+        if max(b, c) >= args.min_ns:
+            if ratio > 1 + args.threshold:
+                status = "REGRESSION"
+                regressions += 1
+            elif ratio < 1 - args.threshold:
+                status = "improvement"
+        print("%-56s %12d %12d %7.2f %s" % (name, b, c, ratio, status))
+
+    for name in sorted(set(base) - set(cur)):
+        print("%-56s only in the baseline" % name)
+    for name in sorted(set(cur) - set(base)):
+        print("%-56s only in the current results" % name)
+
+    print("%d regressions" % regressions)
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,130 @@
+#!/usr/bin/python
+
+# generates parameterised C programs for measuring how pagai scales:
+#
+# nest      : N variables, a nest of D loops, B branches in each loop body
+# automaton : a state machine of S states written as a switch inside a loop,
+#             in the style of the nsichneu WCET benchmark
+#
+# the programs only use linear integer operations, and nondet() for the
+# unknown conditions, so that all the techniques and domains can run on them
+
+from __future__ import print_function
+
+import argparse
+import random
+import sys
+
+
+def var(k):
+    return "x%d" % k
+
+
+def header(out, nvars, nloops):
+    out.append("int nondet(void);")
+    out.append("")
+    out.append("int main(void) {")
+    for k in range(nvars):
+        out.append("\tint %s = 0;" % var(k))
+    for l in range(nloops):
+        out.append("\tint i%d;" % l)
+
+
+def footer(nvars):
+    # every variable is live at the end
+    return "\treturn %s;" % " + ".join(var(k) for k in range(nvars))
+
+
+def branch(rng, nvars, counter, indent):
+    # one branch of a loop body: a guarded increment, bounded by the counter
+    # of the loop or by another variable
+    a = rng.randrange(nvars)
+    b = rng.randrange(nvars)
+    if nvars > 1 and b == a:
+        b = (a + 1) % nvars
+    kind = rng.randrange(3)
+    if kind == 0:
+        cond = "nondet()"
+    elif kind == 1:
+        cond = "%s < %s" % (var(a), counter)
+    else:
+        cond = "%s <= %s" % (var(a), var(b))
+    lines = ["%sif (%s) {" % (indent, cond)]
+    lines.append("%s\t%s = %s + 1;" % (indent, var(a), var(a)))
+    lines.append("%s} else {" % indent)
+    lines.append("%s\t%s = %s;" % (indent, var(b), var(a)))
+    lines.append("%s}" % indent)
+    return lines
+
+
+def gen_nest(nvars, depth, branches, bound, rng):
+    out = []
+    header(out, nvars, depth)
+    indent = "\t"
+    for l in range(depth):
+        out.append("%sfor (i%d = 0; i%d < %d; i%d++) {" % (indent, l, l, bound, l))
+        indent += "\t"
+        for b in range(branches):
+            out.extend(branch(rng, nvars, "i%d" % l, indent))
+    for l in range(depth):
+        indent = indent[:-1]
+        out.append("%s}" % indent)
+    out.append(footer(nvars))
+    out.append("}")
+    return out
+
+
+def gen_automaton(nvars, states, rng):
+    out = []
+    header(out, nvars, 0)
+    out.append("\tint state = 0;")
+    out.append("\twhile (nondet()) {")
+    out.append("\t\tswitch (state) {")
+    for s in range(states):
+        a = s % nvars
+        out.append("\t\t\tcase %d:" % s)
+        out.append("\t\t\t\tif (nondet()) {")
+        out.append("\t\t\t\t\t%s = %s + 1;" % (var(a), var(a)))
+        out.append("\t\t\t\t\tstate = %d;" % ((s + 1) % states))
+        out.append("\t\t\t\t} else {")
+        out.append("\t\t\t\t\t%s = 0;" % var(a))
+        out.append("\t\t\t\t\tstate = %d;" % rng.randrange(states))
+        out.append("\t\t\t\t}")
+        out.append("\t\t\t\tbreak;")
+    out.append("\t\t\tdefault:")
+    out.append("\t\t\t\tstate = 0;")
+    out.append("\t\t}")
+    out.append("\t}")
+    out.append(footer(nvars))
+    out.append("}")
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description="generates a synthetic C program")
+    parser.add_argument("kind", choices=["nest", "automaton"])
+    parser.add_argument("-n", "--vars", type=int, default=4, help="number of variables")
+    parser.add_argument("-d", "--depth", type=int, default=2, help="depth of the loop nest")
+    parser.add_argument("-b", "--branches", type=int, default=2, help="branches per loop body")
+    parser.add_argument("-s", "--states", type=int, default=16, help="states of the automaton")
+    parser.add_argument("--bound", type=int, default=100, help="bound of the loop counters")
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("-o", "--output", help="output file (default: standard output)")
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    if args.kind == "nest":
+        lines = gen_nest(args.vars, args.depth, args.branches, args.bound, rng)
+    else:
+        lines = gen_automaton(args.vars, args.states, rng)
+
+    text = "\n".join(lines) + "\n"
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
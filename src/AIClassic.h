@@ -45,7 +45,7 @@ class AIClassic : public AISimple {
 	private:
 		void init()
 			{
-				aman = new AbstractManClassic();
+				aman = create_abstract_manager(domain);
 				passID.T = SIMPLE;
 			}
 };
@@ -15,10 +15,12 @@
 #include "SMTpass.h"
 #include "Pr.h"
 #include "Debug.h"
+#include "MemStats.h"
 #include "Analyzer.h"
 #include "PathTree.h"
 #include "PathTree_br.h"
 #include "ModulePassWrapper.h"
+#include "Trace.h"
 
 using namespace llvm;
 
@@ -60,8 +62,12 @@ bool AIGuided::runOnModule(Module &M) {
 			pathtree[b] = new std::set<BasicBlock*>();
 		}
 
-		computeFunction(F);
-		Total_time[passID][F] = time_now() - start_time;
+		if (!resumeFunction(F) && !skipStage(F)) {
+			computeFunction(F);
+			Total_time[passID][F] = time_now() - start_time;
+			finishStage(F);
+			checkpointFunction(F);
+		}
 
 		TerminateFunction(F);
 		printResult(F);
@@ -147,27 +153,16 @@ void AIGuided::computeFunction(Function * F) {
 	}
 }
 
-std::set<BasicBlock*> AIGuided::getPredecessors(BasicBlock * b) const {
-	std::set<BasicBlock*> preds;
-	pred_iterator p = pred_begin(b), E = pred_end(b);
-	while (p != E) {
-		preds.insert(*p);
-		p++;
-	}
-	return preds;
+BlockRange AIGuided::getPredecessors(BasicBlock * b) const {
+	return Pr::getInstance(b->getParent())->getCFGPredecessors(b);
 }
 
-std::set<BasicBlock*> AIGuided::getSuccessors(BasicBlock * b) const {
-	std::set<BasicBlock*> succs;
-	succ_iterator p = succ_begin(b), E = succ_end(b);
-	while (p != E) {
-		succs.insert(*p);
-		p++;
-	}
-	return succs;
+BlockRange AIGuided::getSuccessors(BasicBlock * b) const {
+	return Pr::getInstance(b->getParent())->getCFGSuccessors(b);
 }
 
 void AIGuided::computeNewPaths(Node * n) {
+	TraceSpan span("computeNewPaths", n->bb, passID);
 	Node * Succ;
 	BasicBlock * b = n->bb;
 	Abstract * Xtemp = NULL;
@@ -201,6 +196,7 @@ void AIGuided::computeNewPaths(Node * n) {
 		Succ = Nodes[*s];
 
 		asc_iterations[passID][n->bb->getParent()]++;
+		MemStats::iteration(n->bb->getParent(), passID, LSMT);
 
 		// computing the image of the abstract value by the path's tranformation
 		Xtemp = aman->NewAbstract(n->X_s[passID]);
@@ -219,6 +215,7 @@ void AIGuided::computeNewPaths(Node * n) {
 		bool succ_bottom = (Succ->X_s[passID]->is_bottom());
 
 		Xtemp->join_array_dpUcm(&Xtemp_env,aman->NewAbstract(Succ->X_s[passID]));
+		meet_previous_stage(Xtemp,Succ);
 
 		if ( !Xtemp->is_leq(Succ->X_s[passID])) {
 			delete Succ->X_s[passID];
@@ -244,6 +241,7 @@ void AIGuided::computeNewPaths(Node * n) {
 }
 
 void AIGuided::computeNode(Node * n) {
+	TraceSpan span("computeNode", n->bb, passID);
 	BasicBlock * const b = n->bb;
 	Abstract * Xtemp = NULL;
 	Node * Succ = NULL;
@@ -277,6 +275,7 @@ void AIGuided::computeNode(Node * n) {
 		Succ = Nodes[*s];
 
 		asc_iterations[passID][n->bb->getParent()]++;
+		MemStats::iteration(n->bb->getParent(), passID, LSMT);
 
 		// computing the image of the abstract value by the path's tranformation
 		Xtemp = aman->NewAbstract(n->X_s[passID]);
@@ -310,6 +309,7 @@ void AIGuided::computeNode(Node * n) {
 		if (!Succ->X_f[passID]->is_bottom()) {
 			Xtemp->meet(Succ->X_f[passID]);
 		}
+		meet_previous_stage(Xtemp,Succ);
 
 		if ( !Xtemp->is_leq(Succ->X_s[passID])) {
 			delete Succ->X_s[passID];
@@ -333,6 +333,7 @@ void AIGuided::computeNode(Node * n) {
 }
 
 void AIGuided::narrowNode(Node * n) {
+	TraceSpan span("narrowNode", n->bb, passID);
 	Abstract * Xtemp = NULL;
 	Node * Succ;
 	std::list<BasicBlock*> path;
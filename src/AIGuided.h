@@ -55,7 +55,7 @@ class AIGuided : public llvm::ModulePass, public AIPass {
 
 		void init()
 			{
-				aman = new AbstractManClassic();
+				aman = create_abstract_manager(domain);
 				passID.T = GUIDED;
 			}
 
@@ -92,8 +92,8 @@ class AIGuided : public llvm::ModulePass, public AIPass {
 
 		void computeFunction(llvm::Function * F);
 
-		std::set<llvm::BasicBlock*> getPredecessors(llvm::BasicBlock * b) const;
-		std::set<llvm::BasicBlock*> getSuccessors(llvm::BasicBlock * b) const;
+		BlockRange getPredecessors(llvm::BasicBlock * b) const;
+		BlockRange getSuccessors(llvm::BasicBlock * b) const;
 
 		/**
 		 * \brief compute and update the Abstract value of the Node n
@@ -17,7 +17,9 @@
 #include "Live.h"
 #include "Pr.h"
 #include "Debug.h"
+#include "MemStats.h"
 #include "Analyzer.h"
+#include "Trace.h"
 
 using namespace llvm;
 
@@ -72,24 +74,12 @@ void AISimple::computeFunc(Function * F) {
 	}
 }
 
-std::set<BasicBlock*> AISimple::getPredecessors(BasicBlock * b) const {
-	std::set<BasicBlock*> preds;
-	pred_iterator p = pred_begin(b), E = pred_end(b);
-	while (p != E) {
-		preds.insert(*p);
-		p++;
-	}
-	return preds;
+BlockRange AISimple::getPredecessors(BasicBlock * b) const {
+	return Pr::getInstance(b->getParent())->getCFGPredecessors(b);
 }
 
-std::set<BasicBlock*> AISimple::getSuccessors(BasicBlock * b) const {
-	std::set<BasicBlock*> succs;
-	succ_iterator p = succ_begin(b), E = succ_end(b);
-	while (p != E) {
-		succs.insert(*p);
-		p++;
-	}
-	return succs;
+BlockRange AISimple::getSuccessors(BasicBlock * b) const {
+	return Pr::getInstance(b->getParent())->getCFGSuccessors(b);
 }
 
 void AISimple::getAnalysisUsage(AnalysisUsage &AU) const {
@@ -113,8 +103,12 @@ bool AISimple::runOnModule(Module &M) {
 		TimePoint start_time = time_now();
 
 		initFunction(F);
-		computeFunction(F);
-		Total_time[passID][F] = time_now() - start_time;
+		if (!resumeFunction(F) && !skipStage(F)) {
+			computeFunction(F);
+			Total_time[passID][F] = time_now() - start_time;
+			finishStage(F);
+			checkpointFunction(F);
+		}
 		TerminateFunction(F);
 		printResult(F);
 	}
@@ -124,6 +118,7 @@ bool AISimple::runOnModule(Module &M) {
 }
 
 void AISimple::computeNode(Node * n) {
+	TraceSpan span("computeNode", n->bb, passID);
 	BasicBlock * b = n->bb;
 	Abstract * Xtemp;
 	Node * Succ;
@@ -155,6 +150,7 @@ void AISimple::computeNode(Node * n) {
 		Succ = Nodes[*s];
 
 		asc_iterations[passID][n->bb->getParent()]++;
+		MemStats::iteration(n->bb->getParent(), passID, LSMT);
 
 		// computing the image of the abstract value by the path's tranformation
 		Xtemp = aman->NewAbstract(n->X_s[passID]);
@@ -188,6 +184,7 @@ void AISimple::computeNode(Node * n) {
 		if (!Succ->X_f[passID]->is_bottom()) {
 			Xtemp->meet(Succ->X_f[passID]);
 		}
+		meet_previous_stage(Xtemp,Succ);
 
 		if ( !Xtemp->is_leq(Succ->X_s[passID])) {
 			delete Succ->X_s[passID];
@@ -210,6 +207,7 @@ void AISimple::computeNode(Node * n) {
 }
 
 void AISimple::narrowNode(Node * n) {
+	TraceSpan span("narrowNode", n->bb, passID);
 	Abstract * Xtemp;
 	Node * Succ;
 	std::list<BasicBlock*> path;
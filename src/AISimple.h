@@ -35,8 +35,8 @@ class AISimple : public llvm::ModulePass, public AIPass {
 		 */
 		void computeFunc(llvm::Function * F);
 
-		std::set<llvm::BasicBlock*> getPredecessors(llvm::BasicBlock * b) const;
-		std::set<llvm::BasicBlock*> getSuccessors(llvm::BasicBlock * b) const;
+		BlockRange getPredecessors(llvm::BasicBlock * b) const;
+		BlockRange getSuccessors(llvm::BasicBlock * b) const;
 
 		/**
 		 * \{
@@ -14,10 +14,12 @@
 #include "SMTpass.h"
 #include "Pr.h"
 #include "Debug.h"
+#include "MemStats.h"
 #include "Analyzer.h"
 #include "PathTree.h"
 #include "PathTree_br.h"
 #include "ModulePassWrapper.h"
+#include "Trace.h"
 
 using namespace llvm;
 
@@ -173,11 +175,11 @@ end:
 	LSMT->pop_context();
 }
 
-std::set<BasicBlock*> AIdis::getPredecessors(BasicBlock * b) const {
+BlockRange AIdis::getPredecessors(BasicBlock * b) const {
 	return Pr::getInstance(b->getParent())->getPrPredecessors(b);
 }
 
-std::set<BasicBlock*> AIdis::getSuccessors(BasicBlock * b) const {
+BlockRange AIdis::getSuccessors(BasicBlock * b) const {
 	return Pr::getInstance(b->getParent())->getPrSuccessors(b);
 }
 
@@ -189,6 +191,7 @@ int AIdis::sigma(
 }
 
 void AIdis::computeNewPaths(Node * n) {
+	TraceSpan span("computeNewPaths", n->bb, passID);
 	Node * Succ;
 	Abstract * Xtemp = NULL;
 	std::vector<Abstract*> Join;
@@ -197,7 +200,7 @@ void AIdis::computeNewPaths(Node * n) {
 
 	// first, we set X_d abstract values to X_s
 	Pr * FPr = Pr::getInstance(n->bb->getParent());
-	std::set<BasicBlock*> successors = FPr->getPrSuccessors(n->bb);
+	BlockRange successors = FPr->getPrSuccessors(n->bb);
 	for (BasicBlock * bb : successors) {
 		Succ = Nodes[bb];
 		delete Succ->X_d[passID];
@@ -346,6 +349,7 @@ void AIdis::loopiter(
 }
 
 void AIdis::computeNode(Node * n) {
+	TraceSpan span("computeNode", n->bb, passID);
 	BasicBlock * const b = n->bb;
 	Abstract * Xtemp = NULL;
 	Node * Succ = NULL;
@@ -401,6 +405,7 @@ void AIdis::computeNode(Node * n) {
 		Succ = Nodes[path.back()];
 
 		asc_iterations[passID][n->bb->getParent()]++;
+		MemStats::iteration(n->bb->getParent(), passID, LSMT);
 
 		// computing the image of the abstract value by the path's tranformation
 		AbstractDisj * Xdisj = dynamic_cast<AbstractDisj*>(n->X_s[passID]);
@@ -470,6 +475,7 @@ end:
 }
 
 void AIdis::narrowNode(Node * n) {
+	TraceSpan span("narrowNode", n->bb, passID);
 
 	Abstract * Xtemp = NULL;
 	Node * Succ;
@@ -99,8 +99,8 @@ class AIdis : public llvm::ModulePass, public AIPass {
 
 		void computeFunction(llvm::Function * F);
 
-		std::set<llvm::BasicBlock*> getPredecessors(llvm::BasicBlock * b) const;
-		std::set<llvm::BasicBlock*> getSuccessors(llvm::BasicBlock * b) const;
+		BlockRange getPredecessors(llvm::BasicBlock * b) const;
+		BlockRange getSuccessors(llvm::BasicBlock * b) const;
 
 		/**
 		 * \brief compute and update the Abstract value of the Node n
@@ -28,10 +28,12 @@
 #include "SMTpass.h"
 #include "Pr.h"
 #include "Debug.h"
+#include "MemStats.h"
 #include "Analyzer.h"
 #include "PathTree.h"
 #include "PathTree_br.h"
 #include "ModulePassWrapper.h"
+#include "Trace.h"
 
 using namespace llvm;
 
@@ -79,7 +81,12 @@ bool AIopt::runOnModule(Module &M) {
 			}
 		}
 
-		computeFunction(F);
+		if (!resumeFunction(F) && !skipStage(F)) {
+			computeFunction(F);
+			Total_time[passID][F] = time_now() - start_time;
+			finishStage(F);
+			checkpointFunction(F);
+		}
 #if 0
 		struct timespec max_wait;
 		memset(&max_wait, 0, sizeof(max_wait));
@@ -91,7 +98,6 @@ bool AIopt::runOnModule(Module &M) {
 			continue;
 		}
 #endif
-		Total_time[passID][F] = time_now() - start_time;
 
 		TerminateFunction(F);
 		printResult(F);
@@ -137,6 +143,7 @@ void AIopt::computeFunction(Function * F) {
 	P.N = useNewNarrowing();
 	P.TH = useThreshold();
 	assert_properties(P,F);
+	assert_previous_stage(F);
 
 	DEBUG(
 	if (!quiet_mode())
@@ -222,17 +229,18 @@ end:
 	LSMT->pop_context();
 }
 
-std::set<BasicBlock*> AIopt::getPredecessors(BasicBlock * b) const {
+BlockRange AIopt::getPredecessors(BasicBlock * b) const {
 	Pr * FPr = Pr::getInstance(b->getParent());
 	return FPr->getPrPredecessors(b);
 }
 
-std::set<BasicBlock*> AIopt::getSuccessors(BasicBlock * b) const {
+BlockRange AIopt::getSuccessors(BasicBlock * b) const {
 	Pr * FPr = Pr::getInstance(b->getParent());
 	return FPr->getPrSuccessors(b);
 }
 
 void AIopt::computeNewPaths(Node * n) {
+	TraceSpan span("computeNewPaths", n->bb, passID);
 	Node * Succ;
 	Abstract * Xtemp = NULL;
 	std::vector<Abstract*> Join;
@@ -256,13 +264,19 @@ void AIopt::computeNewPaths(Node * n) {
 
 	// first, we set X_d abstract values to X_s
 	Pr * FPr = Pr::getInstance(n->bb->getParent());
-	std::set<BasicBlock*> successors = FPr->getPrSuccessors(n->bb);
+	BlockRange successors = FPr->getPrSuccessors(n->bb);
 	for (BasicBlock * bb : successors) {
 		Succ = Nodes[bb];
 		delete Succ->X_d[passID];
 		Succ->X_d[passID] = aman->NewAbstract(Succ->X_s[passID]);
 	}
 
+	// the sub-cubes are exhausted one after the other: the formula only gets
+	// stronger in this loop, since X_d and pathtree grow, so that a cube
+	// found unsat stays unsat
+	std::vector<SMT_expr> cubes = LSMT->createPathCubes(n->bb, getPathSplit());
+	unsigned cube = 0;
+
 	while (true) {
 		is_computed[n] = true;
 		DEBUG(
@@ -270,9 +284,17 @@ void AIopt::computeNewPaths(Node * n) {
 			*Dbg << "COMPUTENEWPATHS-------------- SMT SOLVE -------------------------\n";
 			resetColor();
 		);
+		// the formula is unsat when the value at the source is bottom
+		if (n->X_s[passID]->is_bottom()) break;
 		// creating the SMTpass formula we want to check
 		LSMT->push_context();
 		SMT_expr pathtree_smt = pathtree[n->bb]->generateSMTformula(LSMT,true);
+		if (cubes.size() > 1) {
+			std::vector<SMT_expr> constraint;
+			constraint.push_back(pathtree_smt);
+			constraint.push_back(cubes[cube]);
+			pathtree_smt = LSMT->man->SMT_mk_and(constraint);
+		}
 		SMT_expr smtexpr = LSMT->createSMTformula(n->bb,useXd,passID,pathtree_smt);
 		std::list<BasicBlock*> path;
 		DEBUG_SMT(
@@ -293,6 +315,8 @@ void AIopt::computeNewPaths(Node * n) {
 				unknown = true;
 				return;
 			}
+			// the next cubes may still contain new paths
+			if (res == 0 && ++cube < cubes.size()) continue;
 			break;
 		}
 
@@ -320,6 +344,7 @@ void AIopt::computeNewPaths(Node * n) {
 		P.N = useNewNarrowing();
 		P.TH = useThreshold();
 		intersect_with_known_properties(Xtemp,Succ,P);
+		meet_previous_stage(Xtemp,Succ);
 
 		//Succ->X_s[passID] = Xtemp;
 		SuccX = Xtemp;
@@ -342,6 +367,7 @@ void AIopt::computeNewPaths(Node * n) {
 }
 
 void AIopt::computeNode(Node * n) {
+	TraceSpan span("computeNode", n->bb, passID);
 	BasicBlock * const b = n->bb;
 	Abstract * Xtemp = NULL;
 	Node * Succ = NULL;
@@ -376,6 +402,8 @@ void AIopt::computeNode(Node * n) {
 			*Dbg << "COMPUTENODE-------------- NEW SMT SOLVE -------------------------\n";
 			resetColor();
 		);
+		// the formula is unsat when the value at the source is bottom
+		if (n->X_s[passID]->is_bottom()) break;
 		LSMT->push_context();
 		// creating the SMTpass formula we want to check
 		SMT_expr pathtree_smt = pathtree[n->bb]->generateSMTformula(LSMT);
@@ -409,6 +437,7 @@ void AIopt::computeNode(Node * n) {
 		Succ = Nodes[path.back()];
 
 		asc_iterations[passID][n->bb->getParent()]++;
+		MemStats::iteration(n->bb->getParent(), passID, LSMT);
 
 		// computing the image of the abstract value by the path's tranformation
 		Xtemp = aman->NewAbstract(n->X_s[passID]);
@@ -430,11 +459,15 @@ void AIopt::computeNode(Node * n) {
 		Join.clear();
 		Join.push_back(aman->NewAbstract(Succ->X_s[passID]));
 		Join.push_back(aman->NewAbstract(Xtemp));
-		Xtemp->join_array(&Xtemp_env,Join);
+		{
+			TraceSpan join_span("join_array", Succ->bb, passID);
+			Xtemp->join_array(&Xtemp_env,Join);
+		}
 
 		Pr * FPr = Pr::getInstance(b->getParent());
 		if (FPr->inPw(Succ->bb) && ((Succ != n) || !only_join)) {
 			if (W->exist(path)) {
+				TraceSpan widening_span("widening", Succ->bb, passID);
 				if (use_threshold) {
 					Xtemp->widening_threshold(Succ->X_s[passID],threshold);
 				} else {
@@ -461,6 +494,7 @@ void AIopt::computeNode(Node * n) {
 		P.N = useNewNarrowing();
 		P.TH = useThreshold();
 		intersect_with_known_properties(Xtemp,Succ,P);
+		meet_previous_stage(Xtemp,Succ);
 
 		Succ->X_s[passID] = Xtemp;
 		Xtemp = NULL;
@@ -477,6 +511,7 @@ void AIopt::computeNode(Node * n) {
 }
 
 void AIopt::narrowNode(Node * n) {
+	TraceSpan span("narrowNode", n->bb, passID);
 	Abstract * Xtemp = NULL;
 	Node * Succ;
 
@@ -498,6 +533,8 @@ void AIopt::narrowNode(Node * n) {
 			*Dbg << "NARROWING----------- NEW SMT SOLVE -------------------------\n";
 			resetColor();
 		);
+		// the formula is unsat when the value at the source is bottom
+		if (n->X_s[passID]->is_bottom()) return;
 		LSMT->push_context();
 		// creating the SMTpass formula we want to check
 		SMT_expr pathtree_smt = pathtree[n->bb]->generateSMTformula(LSMT);
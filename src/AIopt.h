@@ -51,12 +51,15 @@ class AIopt : public llvm::ModulePass, public AIPass {
 		/**
 		 * \brief Computes the new feasible paths and add them to pathtree
 		 * \param n the starting point
+		 *
+		 * With --path-split k, the paths are searched in the sub-cubes of
+		 * SMTpass::createPathCubes, one after the other.
 		 */
 		void computeNewPaths(Node * n);
 
 		void init()
 			{
-				aman = new AbstractManClassic();
+				aman = create_abstract_manager(domain);
 				passID.T = LW_WITH_PF;
 			}
 
@@ -111,8 +114,8 @@ class AIopt : public llvm::ModulePass, public AIPass {
 
 		void computeFunction(llvm::Function * F);
 
-		std::set<llvm::BasicBlock*> getPredecessors(llvm::BasicBlock * b) const;
-		std::set<llvm::BasicBlock*> getSuccessors(llvm::BasicBlock * b) const;
+		BlockRange getPredecessors(llvm::BasicBlock * b) const;
+		BlockRange getSuccessors(llvm::BasicBlock * b) const;
 
 		virtual void assert_properties(params P, llvm::Function * F) { (void) P; (void) F; }
 		virtual void intersect_with_known_properties(Abstract * Xtemp, Node * n, params P) { (void) Xtemp; (void) n; (void) P; }
@@ -16,6 +16,8 @@
 #include "end_3rdparty.h"
 
 #include "AIpass.h"
+#include "AbstractKernel.h"
+#include "Checkpoint.h"
 #include "Pr.h"
 #include "AISimple.h"
 #include "AIGuided.h"
@@ -23,6 +25,8 @@
 #include "Live.h"
 #include "Node.h"
 #include "Debug.h"
+#include "MemStats.h"
+#include "Trace.h"
 #include "recoverName.h"
 #include "utilities.h"
 
@@ -60,6 +64,7 @@ void AIPass::ascendingIter(Node * n, bool dont_reset) {
 
 #define NARROWING_LIMIT 10
 void AIPass::narrowingIter(Node * n) {
+	TraceSpan span("narrowingIter", n->bb, passID);
 	A.push(n);
 	is_computed.clear();
 	std::map<Node*, int> narrowing_limit;
@@ -116,6 +121,10 @@ void AIPass::initFunction(Function * F) {
 	}
 
 	unknown = false;
+	compare_smt_start = abstract_compare_smt;
+	compare_native_start = abstract_compare_native;
+	smt_retries_start = smt_retries_count;
+	smt_escalations_start = smt_escalations_count;
 
 	//if (!quiet_mode()) {
 	if (1) {
@@ -130,6 +139,9 @@ void AIPass::initFunction(Function * F) {
 }
 
 void AIPass::TerminateFunction(Function * F) {
+	dischargeChecks(F);
+	MemStats::endFunction(F, passID, LSMT);
+
 	// Analysis of the function is finished, we can delete and clear internal
 	// data
 	if (!threshold_empty) {
@@ -143,11 +155,172 @@ void AIPass::TerminateFunction(Function * F) {
 	PHIvars_prime.expr.clear();
 	focuspath.clear();
 
+	for (auto & entry : previous_stage_invariants) {
+		delete entry.second;
+	}
+	previous_stage_invariants.clear();
+
+	compare_smt_queries[passID][F] += abstract_compare_smt - compare_smt_start;
+	compare_smt_avoided[passID][F] += abstract_compare_native - compare_native_start;
+	smt_retries[passID][F] += smt_retries_count - smt_retries_start;
+	smt_escalations[passID][F] += smt_escalations_count - smt_escalations_start;
+
 	if (unknown) {
 		ignoreFunction[passID].insert(F);
 	}
 }
 
+bool AIPass::resumeFunction(Function * F) {
+	if (!checkpoint_analysis() || !resume_analysis()) return false;
+	Duration time;
+	bool u;
+	if (!Checkpoint::getInstance()->restore(F, passID, aman, man, time, u))
+		return false;
+	Total_time[passID][F] = time;
+	unknown = u;
+	*Dbg << "// " << F->getName() << " restored from the checkpoint\n";
+	return true;
+}
+
+void AIPass::checkpointFunction(Function * F) {
+	if (!checkpoint_analysis()) return;
+	Checkpoint::getInstance()->save(F, passID, Total_time[passID][F], unknown);
+}
+
+std::map<params,std::set<Function*> > AIPass::stage_finished;
+
+void AIPass::setStage(int i) {
+	stage = i;
+	if (i > 0) {
+		previous_stage = passID;
+		previous_stage.D = getStageDomain(i-1);
+	}
+}
+
+Abstract * AIPass::getPreviousStageInvariant(Node * n) {
+	if (stage <= 0) return NULL;
+	std::map<Node*,Abstract*>::iterator it = previous_stage_invariants.find(n);
+	if (it != previous_stage_invariants.end()) return it->second;
+
+	Abstract * A = NULL;
+	std::map<params,Abstract*>::iterator prev = n->X_s.find(previous_stage);
+	// when the previous stage failed, its abstract values are not invariants
+	if (prev != n->X_s.end() && prev->second != NULL
+			&& !ignoreFunction[previous_stage].count(n->bb->getParent())) {
+		// the two stages have different apron managers, the invariant is
+		// given to this one as a set of constraints
+		Environment env(prev->second);
+		A = aman->NewAbstract(man, &env);
+		if (prev->second->is_bottom()) {
+			A->set_bottom(&env);
+		} else {
+			A->set_top(&env);
+			ap_tcons1_array_t tcons = prev->second->to_tcons_array();
+			Constraint_array cons;
+			size_t size = ap_tcons1_array_size(&tcons);
+			for (size_t k = 0; k < size; k++) {
+				ap_tcons1_t c = ap_tcons1_array_get(&tcons, k);
+				cons.add_constraint(new Constraint(ap_tcons1_copy(&c)));
+			}
+			ap_tcons1_array_clear(&tcons);
+			if (cons.size() > 0) A->meet_tcons_array(&cons);
+		}
+	}
+	previous_stage_invariants[n] = A;
+	return A;
+}
+
+void AIPass::assert_previous_stage(Function * F) {
+	if (stage <= 0) return;
+	assert_invariant(previous_stage, F);
+}
+
+void AIPass::meet_previous_stage(Abstract * Xtemp, Node * n) {
+	Abstract * prev = getPreviousStageInvariant(n);
+	if (prev == NULL) return;
+	Abstract * X = aman->NewAbstract(prev);
+	Environment Xtemp_env(Xtemp);
+	X->change_environment(&Xtemp_env);
+	Xtemp->meet(X);
+	delete X;
+}
+
+bool AIPass::skipStage(Function * F) {
+	if (stage <= 0 || !stage_finished[previous_stage].count(F)) return false;
+	for (Function::iterator it = F->begin(); it != F->end(); ++it) {
+		Node * n = Nodes[it];
+		if (n->X_s[passID] == NULL) continue;
+		Abstract * prev = getPreviousStageInvariant(n);
+		if (prev == NULL) continue;
+		delete n->X_s[passID];
+		n->X_s[passID] = aman->NewAbstract(prev);
+	}
+	stage_finished[passID].insert(F);
+	stage_skipped[passID].insert(F);
+	return true;
+}
+
+void AIPass::finishStage(Function * F) {
+	if (stage < 0 || unknown) return;
+	Pr * FPr = Pr::getInstance(F);
+	bool has_property = false;
+	bool proved = true;
+	bool stable = (stage > 0);
+	for (Function::iterator it = F->begin(); it != F->end(); ++it) {
+		BasicBlock * b = it;
+		Abstract * X = Nodes[b]->X_s[passID];
+		if (X == NULL) continue;
+		if (FPr->getAssert().count(b) || FPr->getUndefinedBehaviour().count(b)) {
+			has_property = true;
+			if (!X->is_bottom()) proved = false;
+		}
+		if (stable) {
+			Abstract * prev = getPreviousStageInvariant(Nodes[b]);
+			if (prev == NULL) continue;
+			Abstract * P = aman->NewAbstract(prev);
+			Environment env(X);
+			P->change_environment(&env);
+			if (!X->is_eq(P)) stable = false;
+			delete P;
+		}
+	}
+	// a more expensive domain is not likely to improve the invariants
+	// if this one did not improve those of the previous stage
+	if ((has_property && proved) || stable)
+		stage_finished[passID].insert(F);
+}
+
+void AIPass::dischargeChecks(Function * F) {
+	std::vector<CallInst*> & checks = Pr::getInstance(F)->getChecks();
+	ub_checks[passID][F] = checks.size();
+	ub_checks_proved[passID][F] = 0;
+	for (CallInst * c : checks) {
+		checks_proved[c] = false;
+	}
+	if (checks.empty() || unknown) return;
+
+	// AISimple does not use the solver during the analysis
+	SMTpass * smt = SMTpass::getInstance();
+	TimePoint start_time = time_now();
+	TraceSpan span("dischargeChecks", F, passID);
+
+	smt->push_context();
+	smt->SMT_assert(smt->getRho(*F));
+	smt->SMT_assert(smt->createInvariantsFormula(F, passID));
+	for (CallInst * c : checks) {
+		smt->push_context();
+		int res = smt->SMTsolve_simple(smt->createCheckFormula(c), PATH_QUERY);
+		smt->pop_context();
+		if (res == 0) {
+			checks_proved[c] = true;
+			ub_checks_proved[passID][F]++;
+		}
+	}
+	smt->pop_context();
+	Total_time_SMT[passID][F] += time_now() - start_time;
+	if (!is_SMT_technique()) smt->reset_SMTcontext();
+}
+
 void format_string(std::string & left) {
 	for (size_t k = 0; k < left.size(); k++) {
 		if (left[k] != '\t')
@@ -188,9 +361,10 @@ void AIPass::computeResultsPositions(Function * F,
 
 void AIPass::printInvariant(BasicBlock * b, std::string left, llvm::raw_ostream * oss) {
 	Pr * FPr = Pr::getInstance(b->getParent());
+	// format string in order to remove undesired characters
+	format_string(left);
+	printChecks(b, left, oss);
 	if (Nodes[b]->X_s[passID] != NULL && FPr->inPr(b)) {
-		// format string in order to remove undesired characters
-		format_string(left);
 		if (FPr->getAssert().count(b)) {
 			if (Nodes[b]->X_s[passID]->is_bottom()) {
 				changeColor(raw_ostream::GREEN,oss);
@@ -328,6 +502,8 @@ void AIPass::assert_invariant(
 	// we assert b_i => I_i for each block
 	for (Function::iterator it = F->begin(); it != F->end(); ++it) {
 		Node * n = Nodes[it];
+		// the SMT techniques only have invariants at the cut points
+		if (!n->X_s.count(P) || n->X_s[P] == NULL) continue;
 		SMT_expr invariant = LSMT->AbstractToSmt(NULL, n->X_s[P]);
 		SMT_var bvar = LSMT->man->SMT_mk_bool_var(LSMT->getNodeName(n->bb, false));
 		SMT_expr block = LSMT->man->SMT_mk_not(LSMT->man->SMT_mk_expr_from_bool_var(bvar));
@@ -339,6 +515,64 @@ void AIPass::assert_invariant(
 }
 
 bool AIPass::copy_Xd_to_Xs(Function * F) {
+	TraceSpan span("copy_Xd_to_Xs", F, passID);
+	switch (getAbstractKernel(aman)) {
+		case CLASSIC_ABSTRACT:
+			return copy_Xd_to_Xs_T<AbstractClassic>(F);
+		case GOPAN_ABSTRACT:
+			return copy_Xd_to_Xs_T<AbstractGopan>(F);
+		case DISJ_ABSTRACT:
+			return copy_Xd_to_Xs_T<AbstractDisj>(F);
+		case INTERVAL_ABSTRACT:
+			return copy_Xd_to_Xs_T<AbstractInterval>(F);
+		default:
+			return copy_Xd_to_Xs_T<Abstract>(F);
+	}
+}
+
+void AIPass::copy_Xs_to_Xf(Function * F) {
+	switch (getAbstractKernel(aman)) {
+		case CLASSIC_ABSTRACT:
+			copy_Xs_to_Xf_T<AbstractClassic>(F);
+			break;
+		case GOPAN_ABSTRACT:
+			copy_Xs_to_Xf_T<AbstractGopan>(F);
+			break;
+		case DISJ_ABSTRACT:
+			copy_Xs_to_Xf_T<AbstractDisj>(F);
+			break;
+		case INTERVAL_ABSTRACT:
+			copy_Xs_to_Xf_T<AbstractInterval>(F);
+			break;
+		default:
+			copy_Xs_to_Xf_T<Abstract>(F);
+			break;
+	}
+}
+
+void AIPass::copy_Xf_to_Xs(Function * F) {
+	switch (getAbstractKernel(aman)) {
+		case CLASSIC_ABSTRACT:
+			copy_Xf_to_Xs_T<AbstractClassic>(F);
+			break;
+		case GOPAN_ABSTRACT:
+			copy_Xf_to_Xs_T<AbstractGopan>(F);
+			break;
+		case DISJ_ABSTRACT:
+			copy_Xf_to_Xs_T<AbstractDisj>(F);
+			break;
+		case INTERVAL_ABSTRACT:
+			copy_Xf_to_Xs_T<AbstractInterval>(F);
+			break;
+		default:
+			copy_Xf_to_Xs_T<Abstract>(F);
+			break;
+	}
+}
+
+template<class AbstractType>
+bool AIPass::copy_Xd_to_Xs_T(Function * F) {
+	typedef AbstractKernel<AbstractType> K;
 	BasicBlock * b;
 	Pr * FPr = Pr::getInstance(F);
 	Environment empty_env;
@@ -347,48 +581,57 @@ bool AIPass::copy_Xd_to_Xs(Function * F) {
 	for (Function::iterator it = F->begin(); it != F->end(); ++it) {
 		b = it;
 		if (!is_SMT_technique() || FPr->inPr(it)) {
-			if (Nodes[b]->X_s[passID]->has_same_environment(Nodes[b]->X_d[passID])) {
-				if (!res && !Nodes[b]->X_s[passID]->is_eq(Nodes[b]->X_d[passID])) {
+			Node * n = Nodes[b];
+			AbstractType * Xs = K::cast(n->X_s[passID]);
+			AbstractType * Xd = K::cast(n->X_d[passID]);
+			if (Xs->has_same_environment(Xd)) {
+				if (!res && !Xs->is_eq(Xd)) {
 					res = true;
 				}
 			} else {
 				res = true;
 			}
 
-			delete Nodes[b]->X_s[passID];
+			delete Xs;
 			if (b != F->begin()) {
-				Nodes[b]->X_s[passID] = Nodes[b]->X_d[passID];
-				Nodes[b]->X_d[passID] = aman->NewAbstract(man, &empty_env);
+				n->X_s[passID] = Xd;
+				n->X_d[passID] = K::create(aman, man, &empty_env);
 			} else {
-				Nodes[b]->X_s[passID] = aman->NewAbstract(Nodes[b]->X_d[passID]);
+				n->X_s[passID] = K::copy(aman, Xd);
 			}
 		}
 	}
 	return res;
 }
 
-void AIPass::copy_Xs_to_Xf(Function * F) {
+template<class AbstractType>
+void AIPass::copy_Xs_to_Xf_T(Function * F) {
+	typedef AbstractKernel<AbstractType> K;
 	BasicBlock * b;
 	Pr * FPr = Pr::getInstance(F);
 
 	for (Function::iterator it = F->begin(); it != F->end(); ++it) {
 		b = it;
 		if (!is_SMT_technique() || FPr->inPr(it)) {
-			delete Nodes[b]->X_f[passID];
-			Nodes[b]->X_f[passID] = aman->NewAbstract(Nodes[b]->X_s[passID]);
+			Node * n = Nodes[b];
+			delete K::cast(n->X_f[passID]);
+			n->X_f[passID] = K::copy(aman, n->X_s[passID]);
 		}
 	}
 }
 
-void AIPass::copy_Xf_to_Xs(Function * F) {
+template<class AbstractType>
+void AIPass::copy_Xf_to_Xs_T(Function * F) {
+	typedef AbstractKernel<AbstractType> K;
 	BasicBlock * b;
 	Pr * FPr = Pr::getInstance(F);
 
 	for (Function::iterator it = F->begin(); it != F->end(); ++it) {
 		b = it;
 		if (!is_SMT_technique() || FPr->inPr(it)) {
-			delete Nodes[b]->X_s[passID];
-			Nodes[b]->X_s[passID] = aman->NewAbstract(Nodes[b]->X_f[passID]);
+			Node * n = Nodes[b];
+			delete K::cast(n->X_s[passID]);
+			n->X_s[passID] = K::copy(aman, n->X_f[passID]);
 		}
 	}
 }
@@ -401,6 +644,36 @@ void AIPass::loopiter(
 		PathTree * const U,
 		PathTree * const V
 		) {
+	TraceSpan span("loopiter", n->bb, passID);
+	switch (getAbstractKernel(aman)) {
+		case CLASSIC_ABSTRACT:
+			loopiter_T<AbstractClassic>(n, Xtemp, path, only_join, U, V);
+			break;
+		case GOPAN_ABSTRACT:
+			loopiter_T<AbstractGopan>(n, Xtemp, path, only_join, U, V);
+			break;
+		case DISJ_ABSTRACT:
+			loopiter_T<AbstractDisj>(n, Xtemp, path, only_join, U, V);
+			break;
+		case INTERVAL_ABSTRACT:
+			loopiter_T<AbstractInterval>(n, Xtemp, path, only_join, U, V);
+			break;
+		default:
+			loopiter_T<Abstract>(n, Xtemp, path, only_join, U, V);
+			break;
+	}
+}
+
+template<class AbstractType>
+void AIPass::loopiter_T(
+		Node * n,
+		Abstract * &Xtemp,
+		std::list<BasicBlock*> * path,
+		bool &only_join,
+		PathTree * const U,
+		PathTree * const V
+		) {
+	typedef AbstractKernel<AbstractType> K;
 	Node * Succ = n;
 	std::vector<Abstract*> Join;
 
@@ -408,39 +681,47 @@ void AIPass::loopiter(
 		if (V->exist(*path)) {
 			only_join = false;
 		} else {
+			AbstractType * X = K::cast(Xtemp);
 			// backup the previous abstract value
-			Abstract * Xpred = aman->NewAbstract(Succ->X_s[passID]);
+			AbstractType * Xpred = K::copy(aman, Succ->X_s[passID]);
 
 			Join.clear();
-			Join.push_back(aman->NewAbstract(Xpred));
-			Join.push_back(aman->NewAbstract(Xtemp));
-			Environment Xtemp_env(Xtemp);
-			Xtemp->join_array(&Xtemp_env,Join);
+			Join.push_back(K::copy(aman, Xpred));
+			Join.push_back(K::copy(aman, X));
+			Environment Xtemp_env(X);
+			{
+				TraceSpan join_span("join_array", n->bb, passID);
+				X->join_array(&Xtemp_env,Join);
+			}
 
 			DEBUG(
 					*Dbg << "BEFORE MINIWIDENING\n";
 					*Dbg << "Succ->X:\n";
 					Succ->X_s[passID]->print();
 					*Dbg << "Xtemp:\n";
-					Xtemp->print();
+					X->print();
 				 );
 
-			if (use_threshold)
-				Xtemp->widening_threshold(Succ->X_s[passID],threshold);
-			else
-				Xtemp->widening(Succ->X_s[passID]);
+			{
+				TraceSpan widening_span("widening", n->bb, passID);
+				if (use_threshold)
+					X->widening_threshold(Succ->X_s[passID],threshold);
+				else
+					X->widening(Succ->X_s[passID]);
+			}
 			DEBUG(
 					*Dbg << "MINIWIDENING!\n";
 				 );
-			delete Succ->X_s[passID];
-			Succ->X_s[passID] = Xtemp;
+			delete K::cast(Succ->X_s[passID]);
+			Succ->X_s[passID] = X;
 			DEBUG(
 					*Dbg << "AFTER MINIWIDENING\n";
-					Xtemp->print();
+					X->print();
 				 );
 
-			Xtemp = aman->NewAbstract(n->X_s[passID]);
-			computeTransform(aman,*path,Xtemp);
+			X = K::copy(aman, n->X_s[passID]);
+			computeTransform_T<AbstractType>(aman,*path,X);
+			Xtemp = X;
 			DEBUG(
 					*Dbg << "POLYHEDRON AT THE STARTING NODE (AFTER MINIWIDENING)\n";
 					n->X_s[passID]->print();
@@ -448,7 +729,7 @@ void AIPass::loopiter(
 					Xtemp->print();
 				 );
 
-			delete Succ->X_s[passID];
+			delete K::cast(Succ->X_s[passID]);
 			Succ->X_s[passID] = Xpred;
 			only_join = true;
 			V->insert(*path);
@@ -467,7 +748,7 @@ void AIPass::computeEnv(Node * n) {
 	std::map<Value*,std::set<ap_var_t> > intVars;
 	std::map<Value*,std::set<ap_var_t> > realVars;
 
-	std::set<BasicBlock*> preds = getPredecessors(b);
+	BlockRange preds = getPredecessors(b);
 
 	if (preds.empty()) {
 		// we are in the first basicblock of the function
@@ -528,6 +809,29 @@ void computeThreshold(
 }
 
 void AIPass::computeTransform (AbstractMan * aman, std::list<BasicBlock*> path, Abstract * Xtemp) {
+	TraceSpan span("computeTransform", path.front(), passID);
+	switch (getAbstractKernel(aman)) {
+		case CLASSIC_ABSTRACT:
+			computeTransform_T<AbstractClassic>(aman, path, AbstractKernel<AbstractClassic>::cast(Xtemp));
+			break;
+		case GOPAN_ABSTRACT:
+			computeTransform_T<AbstractGopan>(aman, path, AbstractKernel<AbstractGopan>::cast(Xtemp));
+			break;
+		case DISJ_ABSTRACT:
+			computeTransform_T<AbstractDisj>(aman, path, AbstractKernel<AbstractDisj>::cast(Xtemp));
+			break;
+		case INTERVAL_ABSTRACT:
+			computeTransform_T<AbstractInterval>(aman, path, AbstractKernel<AbstractInterval>::cast(Xtemp));
+			break;
+		default:
+			computeTransform_T<Abstract>(aman, path, Xtemp);
+			break;
+	}
+}
+
+template<class AbstractType>
+void AIPass::computeTransform_T (AbstractMan * aman, std::list<BasicBlock*> & path, AbstractType * Xtemp) {
+	typedef AbstractKernel<AbstractType> K;
 
 	// setting the focus path, such that the instructions can be correctly
 	// handled
@@ -602,9 +906,9 @@ void AIPass::computeTransform (AbstractMan * aman, std::list<BasicBlock*> path,
 			std::vector<Abstract*> A;
 			// A_Constraints is used by ConstraintsAbstract
 			std::vector<Abstract*> A_Constraints;
-			Abstract * X2;
+			AbstractType * X2;
 			for (Constraint * cstr : *v_cstr) {
-				X2 = aman->NewAbstract(Xtemp);
+				X2 = K::copy(aman, Xtemp);
 				Constraint_array intersect_all(cstr);
 				X2->meet_tcons_array(&intersect_all);
 				A.push_back(X2);
@@ -6,7 +6,9 @@
 #ifndef _AIPASS_H
 #define _AIPASS_H
 
+#include <map>
 #include <queue>
+#include <set>
 #include <vector>
 
 #include "config.h"
@@ -30,6 +32,7 @@
 #include "Constraint.h"
 #include "AbstractMan.h"
 #include "AnalysisPass.h"
+#include "BlockGraph.h"
 
 class SMTpass;
 class Live;
@@ -75,6 +78,20 @@ class AIPass : public AnalysisPass, private llvm::InstVisitor<AIPass> {
 		 */
 		bool unknown;
 
+		/**
+		 * \brief values of abstract_compare_smt and abstract_compare_native
+		 * when the analysis of the current function started
+		 */
+		unsigned long compare_smt_start;
+		unsigned long compare_native_start;
+
+		/**
+		 * \brief values of smt_retries_count and smt_escalations_count
+		 * when the analysis of the current function started
+		 */
+		unsigned long smt_retries_start;
+		unsigned long smt_escalations_start;
+
 		/**
 		 * \brief if true, apply Halbwach's narrowing
 		 */
@@ -131,6 +148,11 @@ class AIPass : public AnalysisPass, private llvm::InstVisitor<AIPass> {
 		 */
 		ap_manager_t* man;
 
+		/**
+		 * \brief abstract domain of the pass
+		 */
+		Apron_Manager_Type domain;
+
 		/**
 		 * \brief manager that creates abstract values
 		 */
@@ -154,6 +176,66 @@ class AIPass : public AnalysisPass, private llvm::InstVisitor<AIPass> {
 				llvm::Function * F
 				);
 
+		/**
+		 * \brief stage of the pass with --stages, -1 otherwise
+		 */
+		int stage;
+
+		/**
+		 * \brief parameters of the previous stage, if stage > 0
+		 */
+		params previous_stage;
+
+		/**
+		 * \brief invariants of the previous stage, converted into the
+		 * abstract domain of the pass
+		 */
+		std::map<Node*,Abstract*> previous_stage_invariants;
+
+		/**
+		 * \brief functions that the next stages do not have to analyze
+		 * again, indexed by the stage that found it
+		 */
+		static std::map<params,std::set<llvm::Function*> > stage_finished;
+
+		/**
+		 * \brief invariant found at n by the previous stage, in the
+		 * abstract domain of the pass
+		 * \return NULL if there is no previous stage, or no invariant at n
+		 */
+		Abstract * getPreviousStageInvariant(Node * n);
+
+		/**
+		 * \brief assert in the SMT formula the invariants of the previous
+		 * stage
+		 */
+		void assert_previous_stage(llvm::Function * F);
+
+		/**
+		 * \brief intersect Xtemp with the invariant of the previous stage
+		 * at n
+		 */
+		void meet_previous_stage(Abstract * Xtemp, Node * n);
+
+		/**
+		 * \brief if the previous stage proved all the properties of F, or
+		 * did not improve the stage before it, takes its invariants as
+		 * they are
+		 * \return true if F does not have to be analyzed
+		 */
+		bool skipStage(llvm::Function * F);
+
+		/**
+		 * \brief decides whether the next stages have to analyze F
+		 */
+		void finishStage(llvm::Function * F);
+
+		/**
+		 * \brief checks the calls to __pagai_check of F against the
+		 * invariants, in a single solver context, and fills checks_proved
+		 */
+		void dischargeChecks(llvm::Function * F);
+
 		/**
 		 * \brief returns false iff the technique computes an invariant at
 		 * each control point
@@ -168,7 +250,8 @@ class AIPass : public AnalysisPass, private llvm::InstVisitor<AIPass> {
 			NewNarrowing(use_New_Narrowing),
 			use_threshold(_use_Threshold),
 			LSMT(NULL) {
-				man = create_manager(_man);
+				domain = _man;
+				man = create_manager(domain);
 				init();
 			}
 
@@ -176,7 +259,8 @@ class AIPass : public AnalysisPass, private llvm::InstVisitor<AIPass> {
 			LV(NULL),
 			unknown(false),
 			LSMT(NULL) {
-				man = create_manager(getApronManager());
+				domain = getApronManager();
+				man = create_manager(domain);
 				NewNarrowing = useNewNarrowing();
 				use_threshold = useThreshold();
 				init();
@@ -187,6 +271,7 @@ class AIPass : public AnalysisPass, private llvm::InstVisitor<AIPass> {
 				Environment empty_env;
 				threshold = new Constraint_array();
 				threshold_empty = false;
+				stage = -1;
 		}
 
 		virtual ~AIPass () {
@@ -199,6 +284,11 @@ class AIPass : public AnalysisPass, private llvm::InstVisitor<AIPass> {
 		 * \brief print a path on standard output
 		 */
 		static void printPath(std::list<llvm::BasicBlock*> path);
+
+		/**
+		 * \brief makes the pass the stage i of --stages
+		 */
+		void setStage(int i);
 	protected:
 
 		/**
@@ -357,6 +447,19 @@ class AIPass : public AnalysisPass, private llvm::InstVisitor<AIPass> {
 		 */
 		void TerminateFunction(llvm::Function * F);
 
+		/**
+		 * \brief with --resume, restores the abstract values and the time
+		 * of F from the checkpoint file
+		 * \return true if F does not have to be analyzed
+		 */
+		bool resumeFunction(llvm::Function * F);
+
+		/**
+		 * \brief with --checkpoint, saves the abstract values of F once it
+		 * has been analyzed
+		 */
+		void checkpointFunction(llvm::Function * F);
+
 		/**
 		 * \brief print a basicBlock on standard output
 		 */
@@ -382,16 +485,47 @@ class AIPass : public AnalysisPass, private llvm::InstVisitor<AIPass> {
 		void printInvariant(llvm::BasicBlock * b, std::string left, llvm::raw_ostream * oss);
 
 		/**
-		 * \brief computes the set of predecessors for a BasicBlock
+		 * \brief returns the predecessors of a BasicBlock
 		 */
-		virtual std::set<llvm::BasicBlock*> getPredecessors(llvm::BasicBlock * b) const = 0;
+		virtual BlockRange getPredecessors(llvm::BasicBlock * b) const = 0;
 
 		/**
-		 * \brief computes the set of Successors for a BasicBlock
+		 * \brief returns the successors of a BasicBlock
 		 */
-		virtual std::set<llvm::BasicBlock*> getSuccessors(llvm::BasicBlock * b) const = 0;
+		virtual BlockRange getSuccessors(llvm::BasicBlock * b) const = 0;
 
 	private:
+		/**
+		 * \{
+		 * \name domain kernels
+		 *
+		 * \brief implementations of the above methods for a given concrete
+		 * type of abstract values (see AbstractKernel). The public methods
+		 * select the instance from the AbstractMan in use.
+		 */
+		template<class AbstractType>
+		bool copy_Xd_to_Xs_T(llvm::Function * F);
+		template<class AbstractType>
+		void copy_Xs_to_Xf_T(llvm::Function * F);
+		template<class AbstractType>
+		void copy_Xf_to_Xs_T(llvm::Function * F);
+		template<class AbstractType>
+		void loopiter_T(
+			Node * n,
+			Abstract * &Xtemp,
+			std::list<llvm::BasicBlock*> * path,
+			bool &only_join,
+			PathTree * const U,
+			PathTree * const V);
+		template<class AbstractType>
+		void computeTransform_T(
+			AbstractMan * aman,
+			std::list<llvm::BasicBlock*> & path,
+			AbstractType * Xtemp);
+		/**
+		 * \}
+		 */
+
 		/**
 		 * \brief Print canonized forms of invariant lists (apron's canonicalize seems not to do the job)
 		 *
@@ -14,10 +14,12 @@
 #include "SMTpass.h"
 #include "Pr.h"
 #include "Debug.h"
+#include "MemStats.h"
 #include "Analyzer.h"
 #include "PathTree.h"
 #include "PathTree_br.h"
 #include "ModulePassWrapper.h"
+#include "Trace.h"
 
 using namespace llvm;
 
@@ -64,8 +66,12 @@ bool AIpf::runOnModule(Module &M) {
 			}
 		}
 
-		computeFunction(F);
-		Total_time[passID][F] = time_now() - start_time;
+		if (!resumeFunction(F) && !skipStage(F)) {
+			computeFunction(F);
+			Total_time[passID][F] = time_now() - start_time;
+			finishStage(F);
+			checkpointFunction(F);
+		}
 
 		TerminateFunction(F);
 		printResult(F);
@@ -110,6 +116,7 @@ void AIpf::computeFunction(Function * F) {
 	P.N = useNewNarrowing();
 	P.TH = useThreshold();
 	assert_properties(P,F);
+	assert_previous_stage(F);
 
 	DEBUG(
 	if (!quiet_mode())
@@ -147,17 +154,18 @@ end:
 	LSMT->pop_context();
 }
 
-std::set<BasicBlock*> AIpf::getPredecessors(BasicBlock * b) const {
+BlockRange AIpf::getPredecessors(BasicBlock * b) const {
 	Pr * FPr = Pr::getInstance(b->getParent());
 	return FPr->getPrPredecessors(b);
 }
 
-std::set<BasicBlock*> AIpf::getSuccessors(BasicBlock * b) const {
+BlockRange AIpf::getSuccessors(BasicBlock * b) const {
 	Pr * FPr = Pr::getInstance(b->getParent());
 	return FPr->getPrSuccessors(b);
 }
 
 void AIpf::computeNode(Node * n) {
+	TraceSpan span("computeNode", n->bb, passID);
 	BasicBlock * b = n->bb;
 	Abstract * Xtemp;
 	Node * Succ;
@@ -191,6 +199,8 @@ void AIpf::computeNode(Node * n) {
 			*Dbg << "--------------- NEW SMT SOLVE -------------------------\n";
 			resetColor();
 		);
+		// the formula is unsat when the value at the source is bottom
+		if (n->X_s[passID]->is_bottom()) return;
 		LSMT->push_context();
 		// creating the SMTpass formula we want to check
 		SMT_expr T = LSMT->man->SMT_mk_true();
@@ -224,6 +234,7 @@ void AIpf::computeNode(Node * n) {
 		Succ = Nodes[path.back()];
 
 		asc_iterations[passID][n->bb->getParent()]++;
+		MemStats::iteration(n->bb->getParent(), passID, LSMT);
 
 		// computing the image of the abstract value by the path's tranformation
 		Xtemp = aman->NewAbstract(n->X_s[passID]);
@@ -249,10 +260,14 @@ void AIpf::computeNode(Node * n) {
 		Join.clear();
 		Join.push_back(aman->NewAbstract(Succ->X_s[passID]));
 		Join.push_back(aman->NewAbstract(Xtemp));
-		Xtemp->join_array(&Xtemp_env,Join);
+		{
+			TraceSpan join_span("join_array", Succ->bb, passID);
+			Xtemp->join_array(&Xtemp_env,Join);
+		}
 
 		Pr * FPr = Pr::getInstance(b->getParent());
 		if (FPr->inPw(Succ->bb) && ((Succ != n) || !only_join)) {
+			TraceSpan widening_span("widening", Succ->bb, passID);
 			if (use_threshold)
 				Xtemp->widening_threshold(Succ->X_s[passID],threshold);
 			else
@@ -283,6 +298,7 @@ void AIpf::computeNode(Node * n) {
 		P.N = useNewNarrowing();
 		P.TH = useThreshold();
 		intersect_with_known_properties(Xtemp,Succ,P);
+		meet_previous_stage(Xtemp,Succ);
 
 		Succ->X_s[passID] = Xtemp;
 
@@ -297,6 +313,7 @@ void AIpf::computeNode(Node * n) {
 }
 
 void AIpf::narrowNode(Node * n) {
+	TraceSpan span("narrowNode", n->bb, passID);
 	Abstract * Xtemp;
 	Node * Succ;
 
@@ -312,6 +329,8 @@ void AIpf::narrowNode(Node * n) {
 			*Dbg << "NARROWING------ NEW SMT SOLVE -------------------------\n";
 			resetColor();
 		);
+		// the formula is unsat when the value at the source is bottom
+		if (n->X_s[passID]->is_bottom()) return;
 		LSMT->push_context();
 		// creating the SMTpass formula we want to check
 		SMT_expr T = LSMT->man->SMT_mk_true();
@@ -366,6 +385,7 @@ void AIpf::narrowNode(Node * n) {
 		P.N = useNewNarrowing();
 		P.TH = useThreshold();
 		intersect_with_known_properties(Xtemp,Succ,P);
+		meet_previous_stage(Xtemp,Succ);
 
 		if (Succ->X_d[passID]->is_bottom()) {
 			delete Succ->X_d[passID];
@@ -32,7 +32,7 @@ class AIpf : public llvm::ModulePass, public AIPass {
 
 		void init()
 			{
-				aman = new AbstractManClassic();
+				aman = create_abstract_manager(domain);
 				passID.T = PATH_FOCUSING;
 			}
 
@@ -70,8 +70,8 @@ class AIpf : public llvm::ModulePass, public AIPass {
 
 		void computeFunction(llvm::Function * F);
 
-		std::set<llvm::BasicBlock*> getPredecessors(llvm::BasicBlock * b) const;
-		std::set<llvm::BasicBlock*> getSuccessors(llvm::BasicBlock * b) const;
+		BlockRange getPredecessors(llvm::BasicBlock * b) const;
+		BlockRange getSuccessors(llvm::BasicBlock * b) const;
 
 		virtual void assert_properties(params P, llvm::Function * F) { (void) P; (void) F; }
 		virtual void intersect_with_known_properties(Abstract * Xtemp, Node * n, params P) { (void) Xtemp; (void) n; (void) P; }
@@ -7,7 +7,9 @@
 #include "Abstract.h"
 #include "AbstractGopan.h"
 #include "AbstractClassic.h"
+#include "AbstractInterval.h"
 #include "Expr.h"
+#include "Debug.h"
 
 int Abstract::compare(Abstract * d) {
 	bool f = false;
@@ -28,6 +30,25 @@ int Abstract::compare(Abstract * d) {
 	}
 #endif
 
+	if (dynamic_cast<AbstractInterval*>(d)
+		&& dynamic_cast<AbstractInterval*>(this)
+		&& has_same_environment(d)) {
+		bool leq = is_leq(d);
+		bool geq = d->is_leq(this);
+		if (leq && geq) return 0;
+		if (leq) return 1;
+		if (geq) return -1;
+		return -2;
+	}
+
+	int res;
+	if (compare_in_domain(d,res)) {
+		// the SMT comparison below makes two queries
+		abstract_compare_native += 2;
+		return res;
+	}
+	abstract_compare_smt += 2;
+
 	SMTpass * LSMT = SMTpass::getInstanceForAbstract();
 
 	LSMT->push_context();
@@ -71,6 +92,20 @@ int Abstract::compare(Abstract * d) {
 	}
 }
 
+bool Abstract::compare_in_domain(Abstract * d, int & res) {
+	(void) d;
+	(void) res;
+	return false;
+}
+
+size_t Abstract::apron_size() {
+	size_t size = 0;
+	if (main != NULL) size += ap_abstract1_size(man,main);
+	// AbstractGopan may share a single value between main and pilot
+	if (pilot != NULL && pilot != main) size += ap_abstract1_size(man,pilot);
+	return size;
+}
+
 bool Abstract::has_same_environment(Abstract * A) {
 	if (ap_environment_is_eq(main->env,A->main->env))
 		return true;
@@ -81,6 +81,21 @@ class Abstract {
 		 */
 		int compare(Abstract * d);
 
+		/**
+		 * \brief compare the abstract value with another one, using the
+		 * abstract domain only
+		 * \param res the result of the comparison, as in compare
+		 * \return false if the domain cannot decide the comparison, in
+		 * which case compare asks the SMT solver
+		 */
+		virtual bool compare_in_domain(Abstract * d, int & res);
+
+		/**
+		 * \brief size of the abstract value, as measured by Apron
+		 * (ap_abstract1_size), for the memory statistics
+		 */
+		virtual size_t apron_size();
+
 		/**
 		 * \brief check if the abstract value can be joined with another one
 		 * without loss of precision
@@ -22,7 +22,7 @@ class AbstractGopan;
  * \class AbstractClassic
  * \brief abstract domain used by every AI pass but AIGopan
  */
-class AbstractClassic: public Abstract {
+class AbstractClassic final : public Abstract {
 
 	protected:
 		/**
@@ -117,6 +117,7 @@ class AbstractClassic: public Abstract {
 				ap_texpr1_t* texpr,
 				size_t size,
 				ap_abstract1_t* dest);
+		using Abstract::assign_texpr_array;
 
 		/**
 		 * \brief the abstract value becomes the join of a set of
@@ -3,6 +3,7 @@
  * \brief Implementation of the AbstractDisj class
  * \author Julien Henry
  */
+#include <algorithm>
 #include <cstdio>
 
 #include "begin_3rdparty.h"
@@ -15,6 +16,20 @@
 #include "Node.h"
 #include "Expr.h"
 #include "Analyzer.h"
+#include "apron.h"
+
+DisjunctSummary::DisjunctSummary(Abstract * A) : bottom(A->is_bottom()) {
+	if (bottom) return;
+	ap_environment_t * env = A->main->env;
+	ap_box1_t B = ap_abstract1_to_box(A->man, A->main);
+	size_t size = env->intdim + env->realdim;
+	for (size_t d = 0; d < size; d++) {
+		box[ap_environment_var_of_dim(env, d)] = std::make_pair(
+				scalar_to_double_down(B.p[d]->inf),
+				scalar_to_double_up(B.p[d]->sup));
+	}
+	ap_box1_clear(&B);
+}
 
 AbstractDisj::AbstractDisj(ap_manager_t* _man, Environment * env) {
 	man_disj = new AbstractManClassic();
@@ -40,11 +55,13 @@ int AbstractDisj::AddDisjunct(Environment * env) {
 
 Abstract * AbstractDisj::getDisjunct(int index) {
 	SetNDisjunct(index);
+	invalidate(index);
 	return disj[index];
 }
 
 void AbstractDisj::setDisjunct(int index, Abstract * A) {
 	SetNDisjunct(index);
+	invalidate(index);
 	disj[index] = A;
 	main = disj[0]->main;
 }
@@ -53,6 +70,14 @@ int AbstractDisj::getMaxIndex() {
 	return disj.size()-1;
 }
 
+const DisjunctSummary & AbstractDisj::getSummary(int index) {
+	SetNDisjunct(index);
+	std::map<int, DisjunctSummary>::iterator it = summaries.find(index);
+	if (it == summaries.end())
+		it = summaries.insert(std::make_pair(index, DisjunctSummary(disj[index]))).first;
+	return it->second;
+}
+
 void AbstractDisj::SetNDisjunct(size_t N) {
 	if (N + 1 <= disj.size()) return;
 	Environment env;
@@ -84,6 +109,7 @@ void AbstractDisj::clear_all() {
 		delete d;
 	}
 	disj.clear();
+	summaries.clear();
 	main = NULL;
 }
 
@@ -98,6 +124,7 @@ void AbstractDisj::set_top(Environment * env) {
 
 void AbstractDisj::set_top(Environment * env, int index) {
 	SetNDisjunct(index);
+	summaries.clear();
 	int i = 0;
 	// every disjunct is at bottom except the one of index 'index'
 	for (Abstract * d : disj) {
@@ -111,6 +138,7 @@ void AbstractDisj::set_top(Environment * env, int index) {
 }
 
 void AbstractDisj::set_bottom(Environment * env) {
+	summaries.clear();
 	for (Abstract * d : disj) {
 		d->set_bottom(env);
 	}
@@ -119,12 +147,14 @@ void AbstractDisj::set_bottom(Environment * env) {
 
 void AbstractDisj::set_bottom(Environment * env, int index) {
 	SetNDisjunct(index);
+	invalidate(index);
 	disj[index]->set_bottom(env);
 	main = disj[0]->main;
 }
 
 
 void AbstractDisj::change_environment(Environment * env) {
+	summaries.clear();
 	for (Abstract * d : disj) {
 		d->change_environment(env);
 	}
@@ -133,6 +163,7 @@ void AbstractDisj::change_environment(Environment * env) {
 
 void AbstractDisj::change_environment(Environment * env, int index) {
 	SetNDisjunct(index);
+	invalidate(index);
 	disj[index]->change_environment(env);
 	if (index == 0)
 		main = disj[0]->main;
@@ -167,6 +198,126 @@ bool AbstractDisj::is_bottom(int index) {
 	return disj[index]->is_bottom();
 }
 
+/**
+ * \brief returns false if the box of S is not included in the box of T
+ */
+static bool box_may_be_leq(const DisjunctSummary & S, const DisjunctSummary & T) {
+	std::map<ap_var_t, std::pair<double, double> >::const_iterator it, et;
+	for (it = S.box.begin(), et = S.box.end(); it != et; it++) {
+		std::map<ap_var_t, std::pair<double, double> >::const_iterator J = T.box.find(it->first);
+		if (J == T.box.end()) continue;
+		if (it->second.first < J->second.first || it->second.second > J->second.second)
+			return false;
+	}
+	return true;
+}
+
+int AbstractDisj::leq_in_domain(AbstractDisj * d) {
+	// non-bottom disjuncts of d, and the bounding box of their union
+	std::vector<int> d_index;
+	DisjunctSummary d_box;
+	for (int j = 0; j < (int)d->disj.size(); j++) {
+		const DisjunctSummary & S = d->getSummary(j);
+		if (S.bottom) continue;
+		if (d_index.empty()) {
+			d_box = S;
+		} else {
+			std::map<ap_var_t, std::pair<double, double> >::iterator it = d_box.box.begin();
+			while (it != d_box.box.end()) {
+				std::map<ap_var_t, std::pair<double, double> >::const_iterator J = S.box.find(it->first);
+				if (J == S.box.end()) {
+					// the variable is not bounded in this disjunct
+					d_box.box.erase(it++);
+					continue;
+				}
+				it->second.first = std::min(it->second.first, J->second.first);
+				it->second.second = std::max(it->second.second, J->second.second);
+				it++;
+			}
+		}
+		d_index.push_back(j);
+	}
+
+	ap_abstract1_t hull;
+	bool has_hull = false;
+	int res = 1;
+	for (int i = 0; i < (int)disj.size() && res == 1; i++) {
+		const DisjunctSummary & S = getSummary(i);
+		if (S.bottom) continue;
+		if (d_index.empty() || !box_may_be_leq(S, d_box)) {
+			res = 0;
+			break;
+		}
+		ap_abstract1_t * X = disj[i]->main;
+		bool included = false;
+		for (int j : d_index) {
+			ap_abstract1_t * Y = d->disj[j]->main;
+			if (!box_may_be_leq(S, d->getSummary(j))) continue;
+			if (!ap_environment_is_eq(X->env, Y->env)) {
+				res = -1;
+				break;
+			}
+			if (ap_abstract1_is_leq(man, X, Y)) {
+				included = true;
+				break;
+			}
+		}
+		if (included || res != 1) continue;
+
+		// X may still be included in the union of several disjuncts of d,
+		// but it is not if it is not included in their convex hull
+		if (!has_hull) {
+			std::vector<ap_abstract1_t> Y;
+			for (int j : d_index) {
+				if (!ap_environment_is_eq(X->env, d->disj[j]->main->env)) break;
+				Y.push_back(*d->disj[j]->main);
+			}
+			if (Y.size() < d_index.size()) {
+				res = -1;
+				break;
+			}
+			hull = ap_abstract1_join_array(man, Y.data(), Y.size());
+			has_hull = true;
+		}
+		if (!ap_environment_is_eq(X->env, hull.env)) {
+			res = -1;
+		} else if (!ap_abstract1_is_leq(man, X, &hull)) {
+			res = 0;
+		} else {
+			res = -1;
+		}
+	}
+	if (has_hull) ap_abstract1_clear(man, &hull);
+	return res;
+}
+
+size_t AbstractDisj::apron_size() {
+	size_t size = 0;
+	for (Abstract * d : disj) {
+		size += d->apron_size();
+	}
+	return size;
+}
+
+bool AbstractDisj::compare_in_domain(Abstract * d, int & res) {
+	AbstractDisj * D = dynamic_cast<AbstractDisj*>(d);
+	if (D == NULL) return false;
+	int leq = leq_in_domain(D);
+	if (leq < 0) return false;
+	int geq = D->leq_in_domain(this);
+	if (geq < 0) return false;
+	if (leq && geq) {
+		res = 0;
+	} else if (leq) {
+		res = 1;
+	} else if (geq) {
+		res = -1;
+	} else {
+		res = -2;
+	}
+	return true;
+}
+
 //NOT IMPLEMENTED
 void AbstractDisj::widening(Abstract * X) {
 	(void) X;
@@ -174,6 +325,7 @@ void AbstractDisj::widening(Abstract * X) {
 
 void AbstractDisj::widening(Abstract * X, int index) {
 	SetNDisjunct(index);
+	invalidate(index);
 	disj[index]->widening(X);
 	main = disj[0]->main;
 }
@@ -186,11 +338,13 @@ void AbstractDisj::widening_threshold(Abstract * X, Constraint_array* cons) {
 
 void AbstractDisj::widening_threshold(Abstract * X, Constraint_array* cons, int index) {
 	SetNDisjunct(index);
+	invalidate(index);
 	disj[index]->widening_threshold(X,cons);
 	main = disj[0]->main;
 }
 
 void AbstractDisj::meet_tcons_array(Constraint_array* tcons) {
+	summaries.clear();
 	for (Abstract * d : disj) {
 		d->meet_tcons_array(tcons);
 	}
@@ -199,11 +353,13 @@ void AbstractDisj::meet_tcons_array(Constraint_array* tcons) {
 
 void AbstractDisj::meet_tcons_array(Constraint_array* tcons, int index) {
 	SetNDisjunct(index);
+	invalidate(index);
 	disj[index]->meet_tcons_array(tcons);
 	main = disj[0]->main;
 }
 
 void AbstractDisj::canonicalize() {
+	summaries.clear();
 	for (Abstract * d : disj) {
 		d->canonicalize();
 	}
@@ -215,6 +371,7 @@ void AbstractDisj::assign_texpr_array(
 		size_t size,
 		ap_abstract1_t* dest
 		) {
+	summaries.clear();
 	for (Abstract * d : disj) {
 		d->assign_texpr_array(tvar, texpr, size, dest);
 	}
@@ -229,6 +386,7 @@ void AbstractDisj::assign_texpr_array(
 		int index
 		) {
 	SetNDisjunct(index);
+	invalidate(index);
 	disj[index]->assign_texpr_array(tvar,texpr,size,dest);
 	main = disj[0]->main;
 }
@@ -241,6 +399,7 @@ void AbstractDisj::join_array(Environment * env, const std::vector<Abstract*> &
 
 void AbstractDisj::join_array(Environment * env, const std::vector<Abstract*> & X_pred, int index) {
 	SetNDisjunct(index);
+	invalidate(index);
 	disj[index]->join_array(env, X_pred);
 	main = disj[0]->main;
 }
@@ -253,6 +412,7 @@ void AbstractDisj::join_array_dpUcm(Environment *env, Abstract* n) {
 
 void AbstractDisj::join_array_dpUcm(Environment *env, Abstract* n, int index) {
 	SetNDisjunct(index);
+	invalidate(index);
 	disj[index]->join_array_dpUcm(env, n);
 	main = disj[0]->main;
 }
@@ -6,6 +6,8 @@
 #ifndef _ABSTRACTDISJ_H
 #define _ABSTRACTDISJ_H
 
+#include <map>
+#include <utility>
 #include <vector>
 
 #include "begin_3rdparty.h"
@@ -18,11 +20,39 @@
 class Node;
 class Sigma;
 
+/**
+ * \class DisjunctSummary
+ * \brief cheap summary of a disjunct: its bounding box
+ *
+ * Used by AbstractDisj::leq_in_domain to discard the disjuncts that cannot
+ * include a given one, before comparing them in the abstract domain.
+ */
+class DisjunctSummary {
+
+	public:
+		/**
+		 * \brief true iff the summarized value is bottom
+		 */
+		bool bottom;
+
+		/**
+		 * \brief bounds of each variable of the environment
+		 */
+		std::map<ap_var_t, std::pair<double, double> > box;
+
+		DisjunctSummary() : bottom(true) {}
+
+		/**
+		 * \brief computes the summary of A
+		 */
+		DisjunctSummary(Abstract * A);
+};
+
 /**
  * \class AbstractDisj
  * \brief Abstract Domain used for computing disjunctive invariants
  */
-class AbstractDisj: public Abstract {
+class AbstractDisj final : public Abstract {
 	friend class Sigma;
 
 	public:
@@ -37,11 +67,31 @@ class AbstractDisj: public Abstract {
 		 */
 		std::vector<Abstract*> disj;
 
+		/**
+		 * \brief summaries of the disjuncts, computed on demand and erased
+		 * each time the disjunct may be modified
+		 */
+		std::map<int, DisjunctSummary> summaries;
+
+		/**
+		 * \brief erase the summary of the disjunct index
+		 */
+		void invalidate(int index) {summaries.erase(index);}
+
 		/**
 		 * \brief clears the abstract value
 		 */
 		void clear_all();
 
+		/**
+		 * \brief checks that each disjunct is included in some disjunct of
+		 * d, or that some disjunct is not even included in the convex hull
+		 * of the disjuncts of d
+		 * \return 1 if this <= d, 0 if not, -1 if it cannot be decided
+		 * without the SMT solver
+		 */
+		int leq_in_domain(AbstractDisj * d);
+
 	public:
 		/**
 		 * create a disjunctive invariant with one sigle disjunct
@@ -87,6 +137,11 @@ class AbstractDisj: public Abstract {
 		 */
 		int getMaxIndex();
 
+		/**
+		 * \brief get the summary of the disjunct of index 'index'
+		 */
+		const DisjunctSummary & getSummary(int index);
+
 		/**
 		 * copy constructor : duplicates the abstract value
 		 */
@@ -167,6 +222,16 @@ class AbstractDisj: public Abstract {
 		 */
 		bool is_top();
 
+		/**
+		 * \brief compare two disjunctive values disjunct by disjunct
+		 */
+		bool compare_in_domain(Abstract * d, int & res);
+
+		/**
+		 * \brief sum of the sizes of the disjuncts
+		 */
+		size_t apron_size();
+
 
 		/**
 		 * \brief apply the widening operator, according to its
@@ -233,6 +298,7 @@ class AbstractDisj: public Abstract {
 				ap_texpr1_t* texpr,
 				size_t size,
 				ap_abstract1_t* dest);
+		using Abstract::assign_texpr_array;
 
 		/**
 		 * \brief assign an expression to a set of variables
@@ -82,6 +82,24 @@ bool AbstractGopan::is_top() {
 	return ap_abstract1_is_top(man,main);
 }
 
+/**
+ * \brief compare two apron values
+ * \return 0, 1, -1 or -2 as in Abstract::compare
+ */
+static int compare_abstract1(ap_manager_t * man, ap_abstract1_t * A, ap_abstract1_t * B) {
+	if (ap_abstract1_is_eq(man,A,B)) return 0;
+	if (ap_abstract1_is_leq(man,A,B)) return 1;
+	if (ap_abstract1_is_leq(man,B,A)) return -1;
+	return -2;
+}
+
+bool AbstractGopan::compare_in_domain(Abstract * d, int & res) {
+	if (dynamic_cast<AbstractGopan*>(d) == NULL || !has_same_environment(d))
+		return false;
+	res = compare_abstract1(man,main,d->main);
+	return true;
+}
+
 void AbstractGopan::widening(Abstract * X) {
 	ap_abstract1_t Xmain_widening;
 	ap_abstract1_t Xpilot_widening;
@@ -21,7 +21,7 @@ class Abstract;
  * \class AbstractGopan
  * \brief abstract domain used by Lookahead Widening algorithm
  */
-class AbstractGopan : public Abstract {
+class AbstractGopan final : public Abstract {
 
 	private:
 		/**
@@ -76,6 +76,12 @@ class AbstractGopan : public Abstract {
 		 */
 		bool is_top();
 
+		/**
+		 * \brief compare the main values, as the comparison through the
+		 * SMT solver does: the pilot values are not compared
+		 */
+		bool compare_in_domain(Abstract * d, int & res);
+
 		/**
 		 * \brief apply the widening operator, according to its
 		 * definition in the domain.
@@ -116,6 +122,7 @@ class AbstractGopan : public Abstract {
 				ap_texpr1_t* texpr,
 				size_t size,
 				ap_abstract1_t* dest);
+		using Abstract::assign_texpr_array;
 
 		/**
 		 * \brief the abstract value becomes the join of a set of
@@ -0,0 +1,752 @@
+/**
+ * \file AbstractInterval.cc
+ * \brief Implementation of the AbstractInterval class
+ * \author agent
+ */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <vector>
+
+#include "begin_3rdparty.h"
+#include "llvm/Support/FormattedStream.h"
+
+#include "ap_global1.h"
+#include "end_3rdparty.h"
+
+#include "Abstract.h"
+#include "AbstractInterval.h"
+#include "AbstractClassic.h"
+#include "Environment.h"
+#include "apron.h"
+#include "Constraint.h"
+#include "Analyzer.h"
+#include "Debug.h"
+
+using namespace llvm;
+
+namespace {
+
+const double INF = std::numeric_limits<double>::infinity();
+
+// Directed rounding of the elementary operations. The rounding error of a
+// double operation is itself a double (two-sum, fma residual): its sign tells
+// on which side of the exact result the rounded one lies.
+
+double add_up(double a, double b) {
+	double s = a + b;
+	if (std::isinf(s)) return s;
+	double bb = s - a;
+	double err = (a - (s - bb)) + (b - bb);
+	return (err > 0) ? std::nextafter(s, INF) : s;
+}
+
+double add_down(double a, double b) {
+	double s = a + b;
+	if (std::isinf(s)) return s;
+	double bb = s - a;
+	double err = (a - (s - bb)) + (b - bb);
+	return (err < 0) ? std::nextafter(s, -INF) : s;
+}
+
+// 0 * inf is 0 for bounds: the dimension multiplied by 0 is bounded
+double mul_up(double a, double b) {
+	if (a == 0 || b == 0) return 0;
+	double p = a * b;
+	if (std::isinf(p)) return p;
+	return (std::fma(a, b, -p) > 0) ? std::nextafter(p, INF) : p;
+}
+
+double mul_down(double a, double b) {
+	if (a == 0 || b == 0) return 0;
+	double p = a * b;
+	if (std::isinf(p)) return p;
+	return (std::fma(a, b, -p) < 0) ? std::nextafter(p, -INF) : p;
+}
+
+// b is never 0. inf/inf only occurs when the divisor is unbounded, in which
+// case the quotient takes values arbitrarily close to 0.
+double div_up(double a, double b) {
+	if (a == 0 || (std::isinf(a) && std::isinf(b))) return 0;
+	double q = a / b;
+	if (std::isinf(q) || std::isinf(b)) return q;
+	double r = std::fma(-q, b, a);
+	return ((r > 0 && b > 0) || (r < 0 && b < 0)) ? std::nextafter(q, INF) : q;
+}
+
+double div_down(double a, double b) {
+	if (a == 0 || (std::isinf(a) && std::isinf(b))) return 0;
+	double q = a / b;
+	if (std::isinf(q) || std::isinf(b)) return q;
+	double r = std::fma(-q, b, a);
+	return ((r < 0 && b > 0) || (r > 0 && b < 0)) ? std::nextafter(q, -INF) : q;
+}
+
+void set_scalar(ap_scalar_t * s, double d) {
+	if (std::isinf(d))
+		ap_scalar_set_infty(s, d > 0 ? 1 : -1);
+	else
+		ap_scalar_set_double(s, d);
+}
+
+// dims[d] is the dimension in env of the dimension d of from, AP_DIM_MAX if
+// the variable is not in env
+void dim_map(ap_environment_t * from, ap_environment_t * env, std::vector<ap_dim_t> & dims) {
+	size_t n = from->intdim + from->realdim;
+	dims.resize(n);
+	if (ap_environment_is_eq(from, env)) {
+		for (size_t d = 0; d < n; d++) dims[d] = d;
+		return;
+	}
+	for (size_t d = 0; d < n; d++)
+		dims[d] = ap_environment_dim_of_var(env, ap_environment_var_of_dim(from, d));
+}
+
+bool add_exact(double a, double b, double & r) {
+	r = a + b;
+	if (std::isinf(r)) return false;
+	double bb = r - a;
+	return (a - (r - bb)) + (b - bb) == 0;
+}
+
+bool mul_exact(double a, double b, double & r) {
+	r = a * b;
+	if (std::isinf(r)) return false;
+	return std::fma(a, b, -r) == 0;
+}
+
+/**
+ * \brief linear form sum(coeff[d] * d) + cst
+ */
+struct LinearForm {
+	std::map<ap_dim_t, double> coeff;
+	double cst;
+
+	LinearForm() : cst(0) {}
+};
+
+// the expression e as an exact linear form with double coefficients, or
+// false if e is not linear or its coefficients are not representable
+bool linearize(ap_texpr0_t * e, const std::vector<ap_dim_t> & dims, size_t intdim, LinearForm & f) {
+	switch (e->discr) {
+		case AP_TEXPR_CST:
+			if (e->val.cst.discr != AP_COEFF_SCALAR) return false;
+			if (ap_scalar_infty(e->val.cst.val.scalar)) return false;
+			if (!ap_double_set_scalar(&f.cst, e->val.cst.val.scalar, GMP_RNDN)) return false;
+			return true;
+		case AP_TEXPR_DIM:
+			if (e->val.dim >= dims.size() || dims[e->val.dim] == AP_DIM_MAX) return false;
+			f.coeff[dims[e->val.dim]] = 1;
+			return true;
+		case AP_TEXPR_NODE:
+			break;
+	}
+	ap_texpr0_node_t * node = e->val.node;
+	if (node->type != AP_RTYPE_REAL && node->type != AP_RTYPE_INT) return false;
+
+	LinearForm A, B;
+	if (!linearize(node->exprA, dims, intdim, A)) return false;
+	if (node->exprB != NULL && !linearize(node->exprB, dims, intdim, B)) return false;
+
+	std::map<ap_dim_t, double>::iterator it;
+	switch (node->op) {
+		case AP_TEXPR_CAST:
+			f = A;
+			break;
+		case AP_TEXPR_NEG:
+			f = A;
+			f.cst = -f.cst;
+			for (it = f.coeff.begin(); it != f.coeff.end(); it++)
+				it->second = -it->second;
+			break;
+		case AP_TEXPR_SUB:
+			B.cst = -B.cst;
+			for (it = B.coeff.begin(); it != B.coeff.end(); it++)
+				it->second = -it->second;
+			// fall through
+		case AP_TEXPR_ADD:
+			f = A;
+			if (!add_exact(A.cst, B.cst, f.cst)) return false;
+			for (it = B.coeff.begin(); it != B.coeff.end(); it++) {
+				double & c = f.coeff[it->first];
+				if (!add_exact(c, it->second, c)) return false;
+			}
+			break;
+		case AP_TEXPR_MUL:
+			if (!A.coeff.empty() && !B.coeff.empty()) return false;
+			if (!A.coeff.empty()) std::swap(A, B);
+			// A is the constant
+			f = B;
+			if (!mul_exact(A.cst, B.cst, f.cst)) return false;
+			for (it = f.coeff.begin(); it != f.coeff.end(); it++)
+				if (!mul_exact(A.cst, it->second, it->second)) return false;
+			break;
+		default:
+			return false;
+	}
+
+	if (node->type == AP_RTYPE_INT) {
+		// rounding the expression to an integer is the identity only if
+		// the linear form only takes integer values
+		if (f.cst != std::floor(f.cst)) return false;
+		for (it = f.coeff.begin(); it != f.coeff.end(); it++)
+			if (it->first >= intdim || it->second != std::floor(it->second)) return false;
+	}
+	return true;
+}
+
+}
+
+AbstractInterval::AbstractInterval(ap_manager_t* _man, Environment * env) {
+	main = NULL;
+	pilot = NULL;
+	man = _man;
+	set_bottom(env);
+}
+
+AbstractInterval::AbstractInterval(Abstract* A) {
+	main = NULL;
+	pilot = NULL;
+	man = A->man;
+	AbstractInterval * B = dynamic_cast<AbstractInterval*>(A);
+	if (B != NULL) {
+		set_environment(B->main->env);
+		inf = B->inf;
+		sup = B->sup;
+		empty = B->empty;
+	} else {
+		from_apron(A->man, A->main);
+	}
+}
+
+void AbstractInterval::clear_all() {
+	ap_abstract1_clear(man, main);
+	delete main;
+}
+
+AbstractInterval::~AbstractInterval() {
+	clear_all();
+}
+
+void AbstractInterval::set_environment(ap_environment_t * env) {
+	if (main != NULL) {
+		if (ap_environment_is_eq(main->env, env)) return;
+		ap_abstract1_clear(man, main);
+	} else {
+		main = new ap_abstract1_t;
+	}
+	*main = ap_abstract1_top(man, env);
+	inf.resize(size());
+	sup.resize(size());
+}
+
+size_t AbstractInterval::size() const {
+	return main->env->intdim + main->env->realdim;
+}
+
+void AbstractInterval::normalize() {
+	if (empty) return;
+	size_t n = size();
+	size_t intdim = main->env->intdim;
+	for (size_t d = 0; d < intdim; d++) {
+		inf[d] = std::ceil(inf[d]);
+		sup[d] = std::floor(sup[d]);
+	}
+	bool e = false;
+	for (size_t d = 0; d < n; d++)
+		e |= (inf[d] > sup[d]) | (inf[d] == INF) | (sup[d] == -INF);
+	empty = e;
+}
+
+void AbstractInterval::bounds_in(
+		const AbstractInterval * A,
+		ap_environment_t * env,
+		std::vector<double> & lo,
+		std::vector<double> & hi) {
+	if (ap_environment_is_eq(A->main->env, env)) {
+		lo = A->inf;
+		hi = A->sup;
+		return;
+	}
+	size_t n = env->intdim + env->realdim;
+	lo.assign(n, -INF);
+	hi.assign(n, INF);
+	for (size_t d = 0; d < n; d++) {
+		ap_dim_t od = ap_environment_dim_of_var(A->main->env, ap_environment_var_of_dim(env, d));
+		if (od == AP_DIM_MAX) continue;
+		lo[d] = A->inf[od];
+		hi[d] = A->sup[od];
+	}
+}
+
+ap_abstract1_t AbstractInterval::to_apron() const {
+	ap_environment_t * env = main->env;
+	if (empty) return ap_abstract1_bottom(man, env);
+	size_t n = size();
+	ap_interval_t ** itv = ap_interval_array_alloc(n);
+	for (size_t d = 0; d < n; d++) {
+		set_scalar(itv[d]->inf, inf[d]);
+		set_scalar(itv[d]->sup, sup[d]);
+	}
+	ap_abstract1_t res = ap_abstract1_of_box(man, env, env->var_of_dim, itv, n);
+	ap_interval_array_free(itv, n);
+	return res;
+}
+
+void AbstractInterval::from_apron(ap_manager_t * m, ap_abstract1_t * a) {
+	set_environment(a->env);
+	if (ap_abstract1_is_bottom(m, a)) {
+		empty = true;
+		return;
+	}
+	empty = false;
+	ap_box1_t box = ap_abstract1_to_box(m, a);
+	size_t n = size();
+	for (size_t d = 0; d < n; d++) {
+		inf[d] = scalar_to_double_down(box.p[d]->inf);
+		sup[d] = scalar_to_double_up(box.p[d]->sup);
+	}
+	ap_box1_clear(&box);
+	normalize();
+}
+
+AbstractClassic * AbstractInterval::to_classic() const {
+	Environment env(main->env);
+	AbstractClassic * C = new AbstractClassic(man, &env);
+	ap_abstract1_clear(man, C->main);
+	*C->main = to_apron();
+	return C;
+}
+
+void AbstractInterval::set_top(Environment * env) {
+	set_environment(env->getEnv());
+	inf.assign(size(), -INF);
+	sup.assign(size(), INF);
+	empty = false;
+}
+
+void AbstractInterval::set_bottom(Environment * env) {
+	set_environment(env->getEnv());
+	inf.assign(size(), INF);
+	sup.assign(size(), -INF);
+	empty = true;
+}
+
+void AbstractInterval::change_environment(Environment * env) {
+	ap_environment_t * e = env->getEnv();
+	if (ap_environment_is_eq(e, main->env)) return;
+	std::vector<double> lo, hi;
+	bounds_in(this, e, lo, hi);
+	set_environment(e);
+	inf.swap(lo);
+	sup.swap(hi);
+}
+
+bool AbstractInterval::is_leq(Abstract * d) {
+	AbstractInterval * D = dynamic_cast<AbstractInterval*>(d);
+	if (D == NULL || !ap_environment_is_eq(main->env, D->main->env))
+		return Abstract::is_leq(d);
+	if (empty) return true;
+	if (D->empty) return false;
+	size_t n = size();
+	bool leq = true;
+	for (size_t k = 0; k < n; k++)
+		leq &= (D->inf[k] <= inf[k]) & (sup[k] <= D->sup[k]);
+	return leq;
+}
+
+bool AbstractInterval::is_eq(Abstract * d) {
+	AbstractInterval * D = dynamic_cast<AbstractInterval*>(d);
+	if (D == NULL || !ap_environment_is_eq(main->env, D->main->env))
+		return Abstract::is_eq(d);
+	if (empty || D->empty) return empty == D->empty;
+	size_t n = size();
+	bool eq = true;
+	for (size_t k = 0; k < n; k++)
+		eq &= (D->inf[k] == inf[k]) & (sup[k] == D->sup[k]);
+	return eq;
+}
+
+bool AbstractInterval::is_bottom() {
+	return empty;
+}
+
+bool AbstractInterval::is_top() {
+	if (empty) return false;
+	size_t n = size();
+	bool top = true;
+	for (size_t d = 0; d < n; d++)
+		top &= (inf[d] == -INF) & (sup[d] == INF);
+	return top;
+}
+
+void AbstractInterval::widening(Abstract * X) {
+	// this becomes X widen (X join this)
+	AbstractInterval Y(X);
+	std::vector<double> lo, hi;
+	bounds_in(&Y, main->env, lo, hi);
+	if (Y.empty) return;
+	if (empty) {
+		inf.swap(lo);
+		sup.swap(hi);
+		empty = false;
+		return;
+	}
+	size_t n = size();
+	for (size_t d = 0; d < n; d++) {
+		inf[d] = (inf[d] < lo[d]) ? -INF : lo[d];
+		sup[d] = (sup[d] > hi[d]) ? INF : hi[d];
+	}
+}
+
+void AbstractInterval::widening_threshold(Abstract * X, Constraint_array* cons) {
+	// Constraint_array::to_lincons1_array does not build the thresholds yet,
+	// so that the widening with thresholds is the standard widening
+	(void) cons;
+	widening(X);
+}
+
+bool AbstractInterval::eval(ap_texpr0_t * e, const std::vector<ap_dim_t> & dims, double & lo, double & hi) const {
+	switch (e->discr) {
+		case AP_TEXPR_CST:
+			if (e->val.cst.discr == AP_COEFF_SCALAR) {
+				lo = scalar_to_double_down(e->val.cst.val.scalar);
+				hi = scalar_to_double_up(e->val.cst.val.scalar);
+			} else {
+				lo = scalar_to_double_down(e->val.cst.val.interval->inf);
+				hi = scalar_to_double_up(e->val.cst.val.interval->sup);
+			}
+			return true;
+		case AP_TEXPR_DIM:
+			if (e->val.dim >= dims.size() || dims[e->val.dim] == AP_DIM_MAX) return false;
+			lo = inf[dims[e->val.dim]];
+			hi = sup[dims[e->val.dim]];
+			return true;
+		case AP_TEXPR_NODE:
+			break;
+	}
+	ap_texpr0_node_t * node = e->val.node;
+	// rounding to a floating point type is left to apron
+	if (node->type != AP_RTYPE_REAL && node->type != AP_RTYPE_INT) return false;
+
+	double alo, ahi, blo = 0, bhi = 0;
+	if (!eval(node->exprA, dims, alo, ahi)) return false;
+	if (node->exprB != NULL && !eval(node->exprB, dims, blo, bhi)) return false;
+
+	switch (node->op) {
+		case AP_TEXPR_CAST:
+			lo = alo;
+			hi = ahi;
+			break;
+		case AP_TEXPR_NEG:
+			lo = -ahi;
+			hi = -alo;
+			break;
+		case AP_TEXPR_ADD:
+			lo = add_down(alo, blo);
+			hi = add_up(ahi, bhi);
+			break;
+		case AP_TEXPR_SUB:
+			lo = add_down(alo, -bhi);
+			hi = add_up(ahi, -blo);
+			break;
+		case AP_TEXPR_MUL:
+			lo = std::min(std::min(mul_down(alo, blo), mul_down(alo, bhi)),
+					std::min(mul_down(ahi, blo), mul_down(ahi, bhi)));
+			hi = std::max(std::max(mul_up(alo, blo), mul_up(alo, bhi)),
+					std::max(mul_up(ahi, blo), mul_up(ahi, bhi)));
+			break;
+		case AP_TEXPR_DIV:
+			if (blo <= 0 && bhi >= 0) return false;
+			lo = std::min(std::min(div_down(alo, blo), div_down(alo, bhi)),
+					std::min(div_down(ahi, blo), div_down(ahi, bhi)));
+			hi = std::max(std::max(div_up(alo, blo), div_up(alo, bhi)),
+					std::max(div_up(ahi, blo), div_up(ahi, bhi)));
+			break;
+		default:
+			return false;
+	}
+	if (node->type == AP_RTYPE_INT) {
+		lo = std::floor(lo);
+		hi = std::ceil(hi);
+	}
+	return true;
+}
+
+void AbstractInterval::refine(const std::map<ap_dim_t, double> & coeff, double cst, ap_constyp_t constyp) {
+	size_t k = coeff.size();
+	std::vector<ap_dim_t> dim(k);
+	std::vector<double> a(k), tlo(k), thi(k);
+
+	// bounds of each term, and of their sum. The infinite terms are counted
+	// apart, so that the bound of the sum of the other terms can be computed
+	// without subtracting infinities.
+	double lo_fin = cst, hi_fin = cst;
+	unsigned lo_inf = 0, hi_inf = 0;
+	size_t j = 0;
+	std::map<ap_dim_t, double>::const_iterator it = coeff.begin(), et = coeff.end();
+	for (; it != et; it++, j++) {
+		dim[j] = it->first;
+		a[j] = it->second;
+		if (a[j] > 0) {
+			tlo[j] = mul_down(a[j], inf[dim[j]]);
+			thi[j] = mul_up(a[j], sup[dim[j]]);
+		} else {
+			tlo[j] = mul_down(a[j], sup[dim[j]]);
+			thi[j] = mul_up(a[j], inf[dim[j]]);
+		}
+		if (std::isinf(tlo[j])) lo_inf++;
+		else lo_fin = add_down(lo_fin, tlo[j]);
+		if (std::isinf(thi[j])) hi_inf++;
+		else hi_fin = add_up(hi_fin, thi[j]);
+	}
+	double slo = lo_inf ? -INF : lo_fin;
+	double shi = hi_inf ? INF : hi_fin;
+
+	switch (constyp) {
+		case AP_CONS_SUPEQ:
+			if (shi < 0) empty = true;
+			break;
+		case AP_CONS_SUP:
+			if (shi <= 0) empty = true;
+			break;
+		case AP_CONS_EQ:
+			if (shi < 0 || slo > 0) empty = true;
+			break;
+		case AP_CONS_DISEQ:
+			if (slo == 0 && shi == 0) empty = true;
+			return;
+		default:
+			return;
+	}
+	if (empty) return;
+
+	for (j = 0; j < k; j++) {
+		ap_dim_t d = dim[j];
+		// a[j] * d >= - (upper bound of the other terms)
+		unsigned other_hi_inf = hi_inf - (std::isinf(thi[j]) ? 1 : 0);
+		if (other_hi_inf == 0) {
+			double rest = std::isinf(thi[j]) ? hi_fin : add_up(hi_fin, -thi[j]);
+			if (a[j] > 0)
+				inf[d] = std::max(inf[d], div_down(-rest, a[j]));
+			else
+				sup[d] = std::min(sup[d], div_up(-rest, a[j]));
+		}
+		if (constyp != AP_CONS_EQ) continue;
+		// a[j] * d <= - (lower bound of the other terms)
+		unsigned other_lo_inf = lo_inf - (std::isinf(tlo[j]) ? 1 : 0);
+		if (other_lo_inf == 0) {
+			double rest = std::isinf(tlo[j]) ? lo_fin : add_down(lo_fin, -tlo[j]);
+			if (a[j] > 0)
+				sup[d] = std::min(sup[d], div_up(-rest, a[j]));
+			else
+				inf[d] = std::max(inf[d], div_down(-rest, a[j]));
+		}
+	}
+	normalize();
+}
+
+void AbstractInterval::meet_tcons_array(Constraint_array* tcons) {
+	Environment main_env(this);
+	Environment cons_env(tcons);
+
+	if (!(cons_env <= main_env)) {
+		// environment of the constraint is not included in main_env
+		// we have to update the environment of the abstract value
+		Environment lcenv(Environment::common_environment(&main_env,&cons_env));
+		change_environment(&lcenv);
+	}
+	if (empty) return;
+
+	ap_tcons1_array_t * array = tcons->to_tcons1_array();
+	std::vector<ap_dim_t> dims;
+	dim_map(array->env, main->env, dims);
+	size_t size = array->tcons0_array.size;
+	std::vector<LinearForm> forms(size);
+	for (size_t i = 0; i < size; i++) {
+		ap_tcons0_t * cons = &array->tcons0_array.p[i];
+		if (cons->constyp == AP_CONS_EQMOD
+				|| !linearize(cons->texpr0, dims, main->env->intdim, forms[i])) {
+			// non-linear constraint: let apron do the whole meet
+			ap_abstract1_t X = to_apron();
+			ap_abstract1_t R = ap_abstract1_meet_tcons_array(man, true, &X, array);
+			from_apron(man, &R);
+			ap_abstract1_clear(man, &R);
+			return;
+		}
+	}
+	for (size_t i = 0; i < size && !empty; i++)
+		refine(forms[i].coeff, forms[i].cst, array->tcons0_array.p[i].constyp);
+}
+
+void AbstractInterval::canonicalize() {
+	normalize();
+}
+
+void AbstractInterval::assign_texpr_array(
+		ap_var_t* tvar,
+		ap_texpr1_t* texpr,
+		size_t size,
+		ap_abstract1_t* dest
+		) {
+	if (empty) return;
+	// all the expressions are evaluated before any assignment
+	std::vector<double> lo(size), hi(size);
+	std::vector<ap_dim_t> target(size);
+	std::vector<ap_dim_t> dims;
+	ap_environment_t * dims_env = NULL;
+	bool native = (dest == NULL);
+	for (size_t i = 0; native && i < size; i++) {
+		target[i] = ap_environment_dim_of_var(main->env, tvar[i]);
+		if (target[i] == AP_DIM_MAX) {
+			native = false;
+			break;
+		}
+		if (texpr[i].env != dims_env) {
+			dim_map(texpr[i].env, main->env, dims);
+			dims_env = texpr[i].env;
+		}
+		native = eval(texpr[i].texpr0, dims, lo[i], hi[i]);
+	}
+	if (!native) {
+		ap_abstract1_t X = to_apron();
+		ap_abstract1_t R = ap_abstract1_assign_texpr_array(man, true, &X, tvar, texpr, size, dest);
+		from_apron(man, &R);
+		ap_abstract1_clear(man, &R);
+		return;
+	}
+	for (size_t i = 0; i < size; i++) {
+		inf[target[i]] = lo[i];
+		sup[target[i]] = hi[i];
+	}
+	normalize();
+}
+
+void AbstractInterval::join_array(Environment * env, const std::vector<Abstract*> & X_pred) {
+	ap_environment_t * e = env->getEnv();
+	set_environment(e);
+	size_t n = size();
+	inf.assign(n, INF);
+	sup.assign(n, -INF);
+	empty = true;
+
+	std::vector<double> lo, hi;
+	for (unsigned i = 0; i < X_pred.size(); i++) {
+		AbstractInterval * Y = dynamic_cast<AbstractInterval*>(X_pred[i]);
+		AbstractInterval * tmp = NULL;
+		if (Y == NULL) Y = tmp = new AbstractInterval(X_pred[i]);
+		if (!Y->empty) {
+			bounds_in(Y, e, lo, hi);
+			for (size_t d = 0; d < n; d++) {
+				inf[d] = std::min(inf[d], lo[d]);
+				sup[d] = std::max(sup[d], hi[d]);
+			}
+			empty = false;
+		}
+		delete tmp;
+		delete X_pred[i];
+	}
+}
+
+void AbstractInterval::join_array_dpUcm(Environment *env, Abstract* n) {
+	std::vector<Abstract*> v;
+	v.push_back(n);
+	v.push_back(new AbstractInterval(this));
+	join_array(env, v);
+}
+
+void AbstractInterval::meet(Abstract* A) {
+	if (empty) return;
+	AbstractInterval Y(A);
+	if (Y.empty) {
+		empty = true;
+		return;
+	}
+	std::vector<double> lo, hi;
+	bounds_in(&Y, main->env, lo, hi);
+	size_t n = size();
+	for (size_t d = 0; d < n; d++) {
+		inf[d] = std::max(inf[d], lo[d]);
+		sup[d] = std::min(sup[d], hi[d]);
+	}
+	normalize();
+}
+
+ap_tcons1_array_t AbstractInterval::to_tcons_array() {
+	ap_abstract1_t X = to_apron();
+	ap_tcons1_array_t res = ap_abstract1_to_tcons_array(man, &X);
+	ap_abstract1_clear(man, &X);
+	return res;
+}
+
+ap_lincons1_array_t AbstractInterval::to_lincons_array() {
+	ap_environment_t * env = main->env;
+	if (empty) {
+		ap_lincons1_array_t array = ap_lincons1_array_make(env, 1);
+		ap_lincons1_t cons = ap_lincons1_make_unsat(env);
+		ap_lincons1_array_set(&array, 0, &cons);
+		return array;
+	}
+	size_t n = size();
+	size_t count = 0;
+	// an infinite bound gives no constraint, even when both bounds are
+	// equal
+	for (size_t d = 0; d < n; d++) {
+		if (inf[d] == sup[d] && std::isfinite(inf[d])) count++;
+		else count += std::isfinite(inf[d]) + std::isfinite(sup[d]);
+	}
+
+	ap_lincons1_array_t array = ap_lincons1_array_make(env, count);
+	size_t k = 0;
+	for (size_t d = 0; d < n; d++) {
+		ap_var_t var = ap_environment_var_of_dim(env, d);
+		// coeff * var + cst constyp 0
+		int coeff[2];
+		double cst[2];
+		ap_constyp_t constyp[2];
+		unsigned m = 0;
+		if (inf[d] == sup[d] && std::isfinite(inf[d])) {
+			coeff[m] = 1; cst[m] = -inf[d]; constyp[m++] = AP_CONS_EQ;
+		} else {
+			if (std::isfinite(inf[d])) {
+				coeff[m] = 1; cst[m] = -inf[d]; constyp[m++] = AP_CONS_SUPEQ;
+			}
+			if (std::isfinite(sup[d])) {
+				coeff[m] = -1; cst[m] = sup[d]; constyp[m++] = AP_CONS_SUPEQ;
+			}
+		}
+		for (unsigned i = 0; i < m; i++) {
+			ap_linexpr1_t expr = ap_linexpr1_make(env, AP_LINEXPR_SPARSE, 1);
+			ap_linexpr1_set_list(&expr,
+					AP_COEFF_S_INT, coeff[i], var,
+					AP_CST_S_DOUBLE, cst[i],
+					AP_END);
+			ap_lincons1_t cons = ap_lincons1_make(constyp[i], &expr, NULL);
+			ap_lincons1_array_set(&array, k++, &cons);
+		}
+	}
+	return array;
+}
+
+void AbstractInterval::print() {
+	*Out << *this;
+}
+
+void AbstractInterval::display(llvm::raw_ostream &stream, std::string * left) const {
+	AbstractClassic * C = to_classic();
+	C->display(stream, left);
+	delete C;
+}
+
+void AbstractInterval::to_MDNode(llvm::Instruction * Inst, std::vector<METADATA_TYPE*> * met) {
+	AbstractClassic * C = to_classic();
+	C->to_MDNode(Inst, met);
+	delete C;
+}
+
+void AbstractInterval::insert_as_LLVM_invariant(llvm::Instruction * Inst) {
+	AbstractClassic * C = to_classic();
+	C->insert_as_LLVM_invariant(Inst);
+	delete C;
+}
@@ -0,0 +1,276 @@
+/**
+ * \file AbstractInterval.h
+ * \brief Declaration of the AbstractInterval class
+ * \author agent
+ */
+#ifndef _ABSTRACTINTERVAL_H
+#define _ABSTRACTINTERVAL_H
+
+#include <map>
+#include <vector>
+
+#include "begin_3rdparty.h"
+#include "ap_global1.h"
+#include "end_3rdparty.h"
+
+#include "Abstract.h"
+#include "config.h"
+
+class AbstractClassic;
+
+/**
+ * \class AbstractInterval
+ * \brief native interval domain, selected with -d native_box
+ *
+ * The bounds are stored in two flat arrays of doubles, indexed by the
+ * dimensions of the apron environment, with directed rounding so that the
+ * computed intervals always contain the exact (rational) ones. Join, meet,
+ * widening and inclusion are branch-free loops over these arrays.
+ *
+ * main is a TOP value of the apron manager that only carries the environment
+ * of the abstract value. The operations that are not handled natively
+ * (non-linear guards, divisions by an interval containing zero, ...) convert
+ * the value into an apron abstract value of the manager, apply the apron
+ * operation and convert the result back.
+ *
+ * There is no native octagon domain: -d oct still goes through apron.
+ */
+class AbstractInterval final : public Abstract {
+
+	protected:
+		/**
+		 * \brief lower bounds, -inf if the dimension is unbounded
+		 */
+		std::vector<double> inf;
+
+		/**
+		 * \brief upper bounds, +inf if the dimension is unbounded
+		 */
+		std::vector<double> sup;
+
+		/**
+		 * \brief true iff the abstract value is bottom
+		 */
+		bool empty;
+
+		/**
+		 * \brief clears the abstract value
+		 */
+		void clear_all();
+
+		/**
+		 * \brief set the environment of the value, without changing the
+		 * bounds
+		 */
+		void set_environment(ap_environment_t * env);
+
+		/**
+		 * \brief number of dimensions in the environment
+		 */
+		size_t size() const;
+
+		/**
+		 * \brief round the bounds of the integer dimensions, and detect empty
+		 * intervals, including [+inf,+inf] and [-inf,-inf]
+		 */
+		void normalize();
+
+		/**
+		 * \brief bounds of the value A in the environment env, unknown
+		 * dimensions are unbounded
+		 */
+		static void bounds_in(
+				const AbstractInterval * A,
+				ap_environment_t * env,
+				std::vector<double> & lo,
+				std::vector<double> & hi);
+
+		/**
+		 * \brief interval of values of a tree expression
+		 * \param e the expression
+		 * \param dims dimension in this environment of each dimension of the
+		 * environment of e
+		 * \return false if the expression cannot be evaluated natively
+		 */
+		bool eval(ap_texpr0_t * e, const std::vector<ap_dim_t> & dims, double & lo, double & hi) const;
+
+		/**
+		 * \brief restrict the bounds with the linear constraint
+		 * sum(coeff[d] * d) + cst constyp 0
+		 */
+		void refine(const std::map<ap_dim_t, double> & coeff, double cst, ap_constyp_t constyp);
+
+		/**
+		 * \brief apron abstract value of the manager equal to this
+		 */
+		ap_abstract1_t to_apron() const;
+
+		/**
+		 * \brief the value becomes the box enclosing the apron abstract value
+		 * a, which is not freed
+		 */
+		void from_apron(ap_manager_t * m, ap_abstract1_t * a);
+
+		/**
+		 * \brief AbstractClassic object equal to this, used for the printing
+		 * and the LLVM outputs
+		 */
+		AbstractClassic * to_classic() const;
+
+	public:
+
+		/**
+		 * \brief creates a BOTTOM abstract value in the environment env
+		 * \param _man apron manager
+		 * \param env the environment of the abstract value
+		 */
+		AbstractInterval(ap_manager_t* _man, Environment * env);
+
+		/**
+		 * \brief copy constructor : duplicates the abstract value
+		 * \param A the abstract value to copy
+		 */
+		AbstractInterval(Abstract* A);
+
+		~AbstractInterval();
+
+		/**
+		 * \brief abstract value is set to top
+		 * \param env environment of the value
+		 */
+		void set_top(Environment * env);
+
+		/**
+		 * \brief abstract value is set to bottom
+		 * \param env environment of the value
+		 */
+		void set_bottom(Environment * env);
+
+		/**
+		 * \brief change the environment of the abstract value
+		 * \param env the new environment
+		 */
+		void change_environment(Environment * env);
+
+		/**
+		 * \brief compare two abstract values
+		 * \param d the second abstract value
+		 * \return true iff this <= d
+		 */
+		bool is_leq(Abstract * d);
+
+		/**
+		 * \brief compare two abstract values
+		 * \param d the second abstract value
+		 * \return true iff this = d
+		 */
+		bool is_eq(Abstract * d);
+
+		/**
+		 * \brief check if the value is bottom
+		 * \return true if the value is bottom, else return false
+		 */
+		bool is_bottom();
+
+		/**
+		 * \brief check if the value is top
+		 * \return true if the value is top, else return false
+		 */
+		bool is_top();
+
+		/**
+		 * \brief apply the widening operator, according to its
+		 * definition in the domain.
+		 * \param X the second argument of the widening operator
+		 */
+		void widening(Abstract * X);
+
+		/**
+		 * \brief apply the widening operator with threshold, according to its
+		 * definition in the domain.
+		 * \param X the second argument of the widening operator
+		 * \param cons the set of constraints to use as thresholds
+		 */
+		void widening_threshold(Abstract * X, Constraint_array* cons);
+
+		/**
+		 * \brief intersect the abstract value with an array of
+		 * constraints
+		 * \param tcons the array of constraints to meet with
+		 */
+		void meet_tcons_array(Constraint_array* tcons);
+
+		/**
+		 * \brief canonicalize the apron representation of the abstract
+		 * value
+		 */
+		void canonicalize();
+
+		/**
+		 * \brief assign an expression to a set of variables
+		 * \param tvar array of the variables to assign
+		 * \param texpr  array of corresponding expressions
+		 * \param size size of the array
+		 * \param dest see apron doc
+		 */
+		void assign_texpr_array(
+				ap_var_t* tvar,
+				ap_texpr1_t* texpr,
+				size_t size,
+				ap_abstract1_t* dest);
+		using Abstract::assign_texpr_array;
+
+		/**
+		 * \brief the abstract value becomes the join of a set of
+		 * abstract values
+		 * \param env the environment of the vector X_pred
+		 * \param X_pred the set of abstract values to join
+		 */
+		void join_array(Environment * env, const std::vector<Abstract*> & X_pred);
+
+		/**
+		 * \brief the abstract value becomes the dpUcm of a set of
+		 * abstract values
+		 * \param env the environment
+		 * \param n the abstract value to join with
+		 *
+		 * See Lookahead Widening - Gopan and Reps - SAS 06 to understand the
+		 * operation dpUcm
+		 */
+		void join_array_dpUcm(Environment *env, Abstract* n);
+
+		/**
+		 * \brief meet the current abstract value with another one
+		 * \param A the abstract value to meet with
+		 */
+		void meet(Abstract* A);
+
+		/**
+		 * \brief convert the abstract value to a conjunction of
+		 * tree constraints
+		 */
+		ap_tcons1_array_t to_tcons_array();
+
+		/**
+		 * \brief convert the abstract value to a conjunction of
+		 * linear constraints
+		 */
+		ap_lincons1_array_t to_lincons_array();
+
+		/**
+		 * \brief print the abstract domain on standard output
+		 */
+		void print();
+
+		/**
+		 * \brief print the abstract domain in the stream
+		 * \param left print the string given as argument at the beginning of
+		 * each new line
+		 */
+		void display(llvm::raw_ostream &stream, std::string * left = NULL) const;
+
+		void to_MDNode(llvm::Instruction * Inst, std::vector<METADATA_TYPE*> * met);
+
+		void insert_as_LLVM_invariant(llvm::Instruction * Inst);
+};
+#endif
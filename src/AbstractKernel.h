@@ -0,0 +1,98 @@
+/**
+ * \file AbstractKernel.h
+ * \brief Declaration of the AbstractKernel template class
+ * \author agent
+ */
+#ifndef _ABSTRACTKERNEL_H
+#define _ABSTRACTKERNEL_H
+
+#include "begin_3rdparty.h"
+#include "ap_global1.h"
+#include "end_3rdparty.h"
+
+#include "Analyzer.h"
+#include "Abstract.h"
+#include "AbstractMan.h"
+#include "AbstractClassic.h"
+#include "AbstractGopan.h"
+#include "AbstractDisj.h"
+#include "AbstractInterval.h"
+#include "Environment.h"
+
+/**
+ * \class AbstractKernel
+ * \brief allocation and cast of abstract values of a known concrete type
+ *
+ * The concrete Abstract classes are final, so every operation called on an
+ * AbstractType pointer is statically dispatched and can be inlined. The
+ * AbstractKernel<Abstract> specialization is the generic path, going through
+ * the virtual AbstractMan and Abstract interfaces.
+ */
+template<class AbstractType>
+class AbstractKernel {
+
+	public:
+		/**
+		 * \brief view an abstract value with its concrete type
+		 */
+		static AbstractType * cast(Abstract * A) {
+			return static_cast<AbstractType*>(A);
+		}
+
+		/**
+		 * \brief creates an abstract value
+		 * \param aman manager of the pass (unused by concrete kernels)
+		 * \param man apron manager
+		 * \param env environment of the created abstract value
+		 */
+		static AbstractType * create(AbstractMan * aman, ap_manager_t * man, Environment * env) {
+			(void) aman;
+			return new AbstractType(man, env);
+		}
+
+		/**
+		 * \brief copy an abstract value
+		 * \param aman manager of the pass (unused by concrete kernels)
+		 * \param A the abstract value
+		 */
+		static AbstractType * copy(AbstractMan * aman, Abstract * A) {
+			(void) aman;
+			return new AbstractType(A);
+		}
+};
+
+template<>
+inline AbstractDisj * AbstractKernel<AbstractDisj>::create(AbstractMan * aman, ap_manager_t * man, Environment * env) {
+	(void) aman;
+	return new AbstractDisj(man, env, 0);
+}
+
+template<>
+class AbstractKernel<Abstract> {
+
+	public:
+		static Abstract * cast(Abstract * A) {
+			return A;
+		}
+
+		static Abstract * create(AbstractMan * aman, ap_manager_t * man, Environment * env) {
+			return aman->NewAbstract(man, env);
+		}
+
+		static Abstract * copy(AbstractMan * aman, Abstract * A) {
+			return aman->NewAbstract(A);
+		}
+};
+
+/**
+ * \brief kernel used for the abstract values created by aman
+ *
+ * returns GENERIC_ABSTRACT when static dispatch is disabled on the command
+ * line (--dispatch virtual)
+ */
+inline AbstractKind getAbstractKernel(AbstractMan * aman) {
+	if (!staticDispatch()) return GENERIC_ABSTRACT;
+	return aman->kind();
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include "AbstractClassic.h"
 #include "AbstractGopan.h"
 #include "AbstractDisj.h"
+#include "AbstractInterval.h"
 
 Abstract * AbstractManClassic::NewAbstract(ap_manager_t * man, Environment * env) {
 	return new AbstractClassic(man,env);
@@ -32,3 +33,17 @@ Abstract * AbstractManDisj::NewAbstract(ap_manager_t * man, Environment * env) {
 Abstract * AbstractManDisj::NewAbstract(Abstract * A) {
 	return new AbstractDisj(A);
 }
+
+Abstract * AbstractManInterval::NewAbstract(ap_manager_t * man, Environment * env) {
+	return new AbstractInterval(man,env);
+}
+
+Abstract * AbstractManInterval::NewAbstract(Abstract * A) {
+	return new AbstractInterval(A);
+}
+
+AbstractMan * create_abstract_manager(Apron_Manager_Type D) {
+	if (D == NATIVE_BOX)
+		return new AbstractManInterval();
+	return new AbstractManClassic();
+}
@@ -10,9 +10,24 @@
 #include "ap_global1.h"
 #include "end_3rdparty.h"
 
+#include "Analyzer.h"
 #include "Abstract.h"
 #include "Environment.h"
 
+/**
+ * \brief concrete type of the Abstract objects created by an AbstractMan
+ *
+ * GENERIC_ABSTRACT means the type is unknown, and every operation has to go
+ * through the virtual Abstract interface.
+ */
+enum AbstractKind {
+	GENERIC_ABSTRACT,
+	CLASSIC_ABSTRACT,
+	GOPAN_ABSTRACT,
+	DISJ_ABSTRACT,
+	INTERVAL_ABSTRACT
+};
+
 /**
  * \class AbstractMan
  * \brief class for creating Abstract objects
@@ -33,6 +48,11 @@ class AbstractMan {
 		 */
 		virtual Abstract * NewAbstract(Abstract * A) = 0;
 
+		/**
+		 * \brief concrete type of the created Abstract objects
+		 */
+		virtual AbstractKind kind() const {return GENERIC_ABSTRACT;}
+
 		virtual ~AbstractMan() {};
 };
 
@@ -54,6 +74,8 @@ class AbstractManClassic : public AbstractMan {
 		 * \param A the abstract value
 		 */
 		Abstract * NewAbstract(Abstract * A);
+
+		AbstractKind kind() const {return CLASSIC_ABSTRACT;}
 };
 
 /**
@@ -74,6 +96,8 @@ class AbstractManGopan : public AbstractMan {
 		 * \param A the abstract value
 		 */
 		Abstract * NewAbstract(Abstract * A);
+
+		AbstractKind kind() const {return GOPAN_ABSTRACT;}
 };
 
 /**
@@ -94,5 +118,35 @@ class AbstractManDisj : public AbstractMan {
 		 * \param A the abstract value
 		 */
 		Abstract * NewAbstract(Abstract * A);
+
+		AbstractKind kind() const {return DISJ_ABSTRACT;}
+};
+
+/**
+ * \class AbstractManInterval
+ * \brief class that create Abstract objects of type AbstractInterval
+ */
+class AbstractManInterval : public AbstractMan {
+
+	public:
+		/**
+		 * \brief creates an object of type AbstractInterval
+		 * \param man apron manager
+		 * \param env environment of the created abstract value
+		 */
+		Abstract * NewAbstract(ap_manager_t * man, Environment * env);
+		/**
+		 * \brief copy an Abstract object
+		 * \param A the abstract value
+		 */
+		Abstract * NewAbstract(Abstract * A);
+
+		AbstractKind kind() const {return INTERVAL_ABSTRACT;}
 };
+
+/**
+ * \brief manager of the non-disjunctive abstract values for the domain D:
+ * AbstractInterval for native_box, AbstractClassic otherwise
+ */
+AbstractMan * create_abstract_manager(Apron_Manager_Type D);
 #endif
@@ -7,6 +7,7 @@
 
 #include "AnalysisPass.h"
 #include "config.h"
+#include "Output.h"
 
 using namespace llvm;
 
@@ -134,11 +135,13 @@ void AnalysisPass::generateAnnotatedCode(
 void AnalysisPass::printResult(Function * F) {
 	if (SVComp()) {
 		assert_fail_found = assert_fail_found || !asserts_proved(F);
-		return;
+	} else {
+		if (generateMetadata()) InstrumentLLVMBitcode(F);
+		if (!quiet_mode() && !useSourceName())
+			printResult_oldoutput(F);
 	}
-	if (generateMetadata()) InstrumentLLVMBitcode(F);
-	if (quiet_mode() || useSourceName()) return;
-	printResult_oldoutput(F);
+	// everything printed during the analysis of F is written in one block
+	OutputSink::commitOutput();
 }
 
 void AnalysisPass::printResult_oldoutput(Function * F) {
@@ -192,9 +195,51 @@ void AnalysisPass::printResult_oldoutput(Function * F) {
 			}
 		}
 	}
+	for (CallInst * c : FPr->getChecks()) {
+		changeColor(raw_ostream::MAGENTA);
+		*Out << "\n\nRESULT FOR CHECK: " << *c << "\n";
+		if (checks_proved[c]) {
+			changeColor(raw_ostream::GREEN);
+			*Out << "safe\n";
+		} else {
+			changeColor(raw_ostream::RED);
+			*Out << "unsafe\n";
+			*Out << getUndefinedBehaviourMessage(c->getParent()) << "\n";
+		}
+		resetColor();
+	}
 	*Out << Total_time[passID][F].count() << " seconds\n";
+	*Out << "SMT TIME " << Total_time_SMT[passID][F].count() << "\n";
+	*Out << "PR SIZE " << FPr->getPr().size() << "\n";
+	*Out << "PW SIZE " << FPr->getPw().size() << "\n";
 	*Out << "ASC ITERATIONS " << asc_iterations[passID][F] << "\n" ;
 	*Out << "DESC ITERATIONS " << desc_iterations[passID][F] << "\n" ;
+	*Out << "SMT QUERIES " << smt_queries[passID][F] << "\n" ;
+	*Out << "SMT QUERY ASSERTIONS " << smt_query_assertions[passID][F] << "\n" ;
+	*Out << "SMT PIPE BYTES " << smt_pipe_bytes[passID][F] << "\n" ;
+	*Out << "SMT PARSE TIME " << Total_time_SMT_parse[passID][F].count() << "\n" ;
+	*Out << "COMPARE SMT QUERIES " << compare_smt_queries[passID][F] << "\n" ;
+	*Out << "COMPARE SMT AVOIDED " << compare_smt_avoided[passID][F] << "\n" ;
+	*Out << "SMT RETRIES " << smt_retries[passID][F] << "\n" ;
+	*Out << "SMT ESCALATIONS " << smt_escalations[passID][F] << "\n" ;
+	*Out << "UB CHECKS " << ub_checks[passID][F] << "\n" ;
+	*Out << "UB CHECKS PROVED " << ub_checks_proved[passID][F] << "\n" ;
+}
+
+void AnalysisPass::printChecks(BasicBlock * b, std::string left, llvm::raw_ostream * oss) {
+	for (BasicBlock::iterator it = b->begin(); it != b->end(); ++it) {
+		CallInst * c = dyn_cast<CallInst>(it);
+		if (c == NULL || !checks_proved.count(c)) continue;
+		if (checks_proved[c]) {
+			changeColor(raw_ostream::GREEN,oss);
+			*oss << "// safe\n";
+		} else {
+			changeColor(raw_ostream::RED,oss);
+			*oss << "// unsafe: " << getUndefinedBehaviourMessage(b) << "\n";
+		}
+		resetColor(oss);
+		*oss << left;
+	}
 }
 
 std::string AnalysisPass::getUndefinedBehaviourMessage(BasicBlock * b) {
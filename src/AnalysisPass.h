@@ -37,6 +37,12 @@ class AnalysisPass {
 		 */
 		params passID;
 
+		/**
+		 * \brief result of each call to __pagai_check: true iff the check
+		 * is proved never to fail
+		 */
+		std::map<llvm::CallInst*, bool> checks_proved;
+
 		AnalysisPass() : assert_fail_found(false) {}
 
 		/**
@@ -84,5 +90,11 @@ class AnalysisPass {
 
 		std::string getUndefinedBehaviourMessage(llvm::BasicBlock * b);
 
+		/**
+		 * \brief prints the result of the checks of b on oss, with an
+		 * optional padding
+		 */
+		void printChecks(llvm::BasicBlock * b, std::string left, llvm::raw_ostream * oss);
+
 };
 #endif
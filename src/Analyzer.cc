@@ -25,8 +25,12 @@ bool bagnara_widening;
 bool defined_main;
 bool use_source_name;
 bool printAll;
+bool static_dispatch;
+bool minimize_cutpoints;
+bool topological_worklist;
 std::string main_function;
 Apron_Manager_Type ap_manager[2];
+std::vector<Apron_Manager_Type> stages;
 bool Narrowing[2];
 bool Threshold[2];
 llvm::raw_ostream *Out;
@@ -36,6 +40,7 @@ std::string annotatedFilename;
 std::string annotatedBCFilename;
 int npass;
 int timeout;
+int smt_budget;
 std::map<Techniques,int> Passes;
 std::vector<enum Techniques> TechniquesToCompare;
 
@@ -44,6 +49,9 @@ Techniques getTechnique() {return technique;}
 bool compareTechniques() {return vm.count("compare");}
 bool compareDomain() {return vm.count("comparedomains");}
 bool compareNarrowing() {return vm.count("comparenarrowing");}
+bool useStages() {return stages.size() > 0;}
+int getNumStages() {return stages.size();}
+Apron_Manager_Type getStageDomain(int i) {return stages[i];}
 bool onlyOutputsRho() {return vm.count("printformula");}
 bool skipNonLinear() {return vm.count("skipnonlinear");}
 bool useSourceName() {return use_source_name;}
@@ -55,6 +63,8 @@ bool brutal_unrolling() {return vm.count("loop-unroll");}
 bool loop_rotate() {return !vm.count("no-loop-rotate");}
 bool global2local() {return !vm.count("no-global2local");}
 bool dumpll() {return vm.count("dump-ll");}
+bool useBitcodeCache() {return vm.count("bc-cache");}
+std::string getBitcodeCacheDir() {return vm["bc-cache"].as<std::string>();}
 bool WCETSettings() {return vm.count("wcet");}
 bool generateMetadata() {return annotatedBCFilename.size();}
 bool InvariantAsMetadata() {return vm.count("output-bc-v2");}
@@ -65,6 +75,7 @@ bool OutputAnnotatedFile() {return annotatedFilename.length() > 0;}
 std::string getAnnotatedFilename() {return annotatedFilename;}
 int getTimeout() {return timeout;}
 bool hasTimeout() {return vm.count("timeout");}
+int getSMTBudget() {return smt_budget;}
 std::string getFilename() {return vm["input"].as<std::string>();}
 bool SVComp() {return vm.count("svcomp");}
 Apron_Manager_Type getApronManager() {return ap_manager[0];}
@@ -77,8 +88,24 @@ bool definedMain() {return defined_main;}
 std::string getMain() {return main_function;}
 bool quiet_mode() {return vm.count("quiet");}
 bool log_smt_into_file() {return vm.count("log-smt");}
+bool capture_smt() {return vm.count("smt-capture");}
+bool rhoSlices() {return vm.count("rho-slices");}
+bool trace_analysis() {return vm.count("trace");}
+std::string getTraceFilename() {return vm["trace"].as<std::string>();}
+bool memStats() {return vm.count("memstats");}
+std::string getMemStatsFilename() {return vm["memstats"].as<std::string>();}
+int getMemStatsInterval() {return vm["memstats-interval"].as<int>();}
+bool checkpoint_analysis() {return vm.count("checkpoint");}
+std::string getCheckpointFilename() {return vm["checkpoint"].as<std::string>();}
+bool resume_analysis() {return vm.count("resume");}
+std::string getSMTCaptureFilename() {return vm["smt-capture"].as<std::string>();}
+std::string getSMTSolverName() {return vm["solver"].as<std::string>();}
 bool optimizeBC() {return vm.count("optimize");}
 bool InstCombining() {return vm.count("instcombining");}
+bool staticDispatch() {return static_dispatch;}
+bool minimizeCutPoints() {return minimize_cutpoints;}
+bool topologicalWorklist() {return topological_worklist;}
+int getPathSplit() {return vm["path-split"].as<int>();}
 std::vector<enum Techniques> & getComparedTechniques() {return TechniquesToCompare;}
 
 std::string TechniquesToString(Techniques t) {
@@ -105,34 +132,72 @@ std::string TechniquesToString(Techniques t) {
 }
 
 
-bool setApronManager(std::string d, int i) {
-
+Apron_Manager_Type ApronManagerFromString(bool &error, std::string d) {
+	error = false;
 	if (!d.compare("box")) {
-		ap_manager[i] = BOX;
+		return BOX;
 	} else if (!d.compare("oct")) {
-		ap_manager[i] = OCT;
+		return OCT;
 	} else if (!d.compare("pk")) {
-		ap_manager[i] = PK;
+		return PK;
 	} else if (!d.compare("pkeq")) {
-		ap_manager[i] = PKEQ;
+		return PKEQ;
+	} else if (!d.compare("native_box")) {
+		return NATIVE_BOX;
 #ifdef OPT_OCT_ENABLED
 	} else if (!d.compare("opt_oct")) {
-		ap_manager[i] = OPT_OCT;
+		return OPT_OCT;
 #endif
 #ifdef PPL_ENABLED
 	} else if (!d.compare("ppl_poly_bagnara")) {
-		ap_manager[i] = PPL_POLY_BAGNARA;
+		return PPL_POLY_BAGNARA;
 	} else if (!d.compare("ppl_poly")) {
-		ap_manager[i] = PPL_POLY;
+		return PPL_POLY;
 	} else if (!d.compare("ppl_grid")) {
-		ap_manager[i] = PPL_GRID;
+		return PPL_GRID;
 	} else if (!d.compare("pkgrid")) {
-		ap_manager[i] = PKGRID;
+		return PKGRID;
 #endif
-	} else {
+	}
+	error = true;
+	return PK;
+}
+
+bool setApronManager(std::string d, int i) {
+	bool error;
+	Apron_Manager_Type D = ApronManagerFromString(error,d);
+	if (error) {
 		std::cout << "Wrong parameter defining the abstract domain\n";
 		return 1;
 	}
+	ap_manager[i] = D;
+	return 0;
+}
+
+bool setStages(std::string d) {
+	size_t start = 0;
+	while (start <= d.size()) {
+		size_t end = d.find(',', start);
+		if (end == std::string::npos) end = d.size();
+		bool error;
+		Apron_Manager_Type D = ApronManagerFromString(error,d.substr(start,end-start));
+		if (error) {
+			std::cout << "Wrong parameter defining the abstract domain of a stage\n";
+			return 1;
+		}
+		for (Apron_Manager_Type S : stages) {
+			if (S == D) {
+				std::cout << "The same abstract domain is used by two stages\n";
+				return 1;
+			}
+		}
+		stages.push_back(D);
+		start = end + 1;
+	}
+	if (stages.size() > MAX_STAGES) {
+		std::cout << "At most " << MAX_STAGES << " stages are supported\n";
+		return 1;
+	}
 	return 0;
 }
 
@@ -146,6 +211,8 @@ std::string ApronManagerToString(Apron_Manager_Type D) {
 			return "PK";
 		case PKEQ:
 			return "PKEQ";
+		case NATIVE_BOX:
+			return "NATIVE_BOX";
 #ifdef OPT_OCT_ENABLED
 		case OPT_OCT:
 			return "OPT_OCT";
@@ -227,6 +294,42 @@ bool setSolver(std::string d) {
 	return 0;
 }
 
+bool setDispatch(std::string d) {
+	if (!d.compare("static")) {
+		static_dispatch = true;
+	} else if (!d.compare("virtual")) {
+		static_dispatch = false;
+	} else {
+		std::cout << "Wrong parameter defining the dispatch of abstract operations\n";
+		return 1;
+	}
+	return 0;
+}
+
+bool setCutPoints(std::string d) {
+	if (!d.compare("loops")) {
+		minimize_cutpoints = false;
+	} else if (!d.compare("fvs")) {
+		minimize_cutpoints = true;
+	} else {
+		std::cout << "Wrong parameter defining the selection of cut points\n";
+		return 1;
+	}
+	return 0;
+}
+
+bool setWorklistOrder(std::string d) {
+	if (!d.compare("scc")) {
+		topological_worklist = false;
+	} else if (!d.compare("topological")) {
+		topological_worklist = true;
+	} else {
+		std::cout << "Wrong parameter defining the order of the worklist\n";
+		return 1;
+	}
+	return 0;
+}
+
 bool setMain(std::string m) {
 	main_function.assign(m);
 	defined_main = true;
@@ -287,7 +390,8 @@ std::string domain_help() {
 	* box (Apron boxes)\n\
 	* oct (Octagons)\n\
 	* pk (NewPolka strict polyhedra)\n\
-	* pkeq (NewPolka linear equalities)";
+	* pkeq (NewPolka linear equalities)\n\
+	* native_box (boxes implemented in PAGAI, Apron boxes for the other operations)";
 #ifdef PPL_ENABLED
    doc +=
 	"\n\
@@ -353,6 +457,8 @@ void check_help_or_version(const po::options_description & desc) {
 	}
 }
 
+// pagai-microbench links the sources of PAGAI with its own main
+#ifndef PAGAI_NO_MAIN
 int main(int argc, char* argv[]) {
 
 	execute run;
@@ -373,6 +479,9 @@ int main(int argc, char* argv[]) {
 	defined_main = false;
 	use_source_name = true;
 	printAll = false;
+	static_dispatch = true;
+	minimize_cutpoints = false;
+	topological_worklist = false;
 	n_totalpaths = 0;
 	n_paths = 0;
 	npass = 0;
@@ -413,13 +522,33 @@ int main(int argc, char* argv[]) {
 	  ("debug", "debug")
 	  ("compare,c", po::value< std::vector<std::string> >(&compare_list), "compare list of techniques")
 	  ("comparedomains", "compare abstract domains")
+	  ("stages", po::value<std::string>(), "comma-separated list of abstract domains (e.g. box,oct,pk): the analysis is run once per domain, each run using the invariants of the previous one")
 	  ("printformula", "print SMT formula")
 	  ("printall", "print all")
 	  ("quiet", "quiet mode")
 	  ("dump-ll", "dump analyzed ll file")
+	  ("bc-cache", po::value<std::string>(), "directory where the bitcode obtained after the preprocessing passes is cached, and reused by the next runs on the same input")
 	  ("force-old-output", "use old output")
 	  ("timeout", po::value<std::string>(), "timeout")
+	  ("smt-budget", po::value<int>(&smt_budget)->default_value(1000), "time budget in milliseconds of the first check of an SMT query, multiplied by 4 at each retry when the answer is unknown, up to the timeout (0: a single check, only limited by the timeout; only with z3)")
 	  ("log-smt", "write all the SMT requests into a log file")
+	  ("smt-capture", po::value<std::string>(), "record every SMT query, with its result and solving time, into a file that can be replayed with pagai-smt-replay")
+	  ("trace", po::value<std::string>(), "write a timeline of the analysis into a file in the Chrome trace-event format (chrome://tracing, Perfetto)")
+	  ("memstats", po::value<std::string>(), "print the memory used at the end of each analyzed function, and write all the samples into a JSON file")
+	  ("memstats-interval", po::value<int>()->default_value(0), "with --memstats, also sample the memory every N ascending iterations (0: only at the end of each function)")
+	  ("checkpoint", po::value<std::string>(), "after each analyzed function, save its invariants into a file")
+	  ("resume", "with --checkpoint, restore the functions saved in the file instead of analyzing them again")
+	  ("rho-slices", "in each SMT query, only enable the part of the formula reachable from the source block")
+	  ("dispatch", po::value<std::string>()->default_value("static"), "dispatch of the abstract operations in the fixpoint engines\n\
+	* static (per-domain kernels)\n\
+	* virtual (generic Abstract interface)")
+	  ("cutpoints", po::value<std::string>()->default_value("loops"), "selection of the cut points (widening points)\n\
+	* loops (all loop headers)\n\
+	* fvs (loop headers not needed to cut the cycles are removed)")
+	  ("worklist", po::value<std::string>()->default_value("scc"), "order in which the fixpoint engines pop the nodes\n\
+	* scc (by strongly connected component)\n\
+	* topological (topological order of the DAG of the strongly connected components: a loop nest is stabilized once its entry values are)")
+	  ("path-split", po::value<int>()->default_value(0), "in the lw+pf technique, enumerate the new paths from a block in 2^k sub-cubes, fixing the first k branches of the paths (0: no split)")
 	  //("annotated", po::value<std::string>(&annotatedFilename), "name of the annotated C file")
 	  ("domain2", po::value<std::string>(), "not for use")
 	  ("new-narrowing2", "not for use")
@@ -446,6 +575,13 @@ int main(int argc, char* argv[]) {
 	if (vm.count("timeout")) setTimeout(vm["timeout"].as<std::string>());
 	if (vm.count("main")) setMain(vm["main"].as<std::string>());
 	if (vm.count("domain2")) setApronManager(vm["domain2"].as<std::string>(),1);
+	setDispatch(vm["dispatch"].as<std::string>());
+	setCutPoints(vm["cutpoints"].as<std::string>());
+	setWorklistOrder(vm["worklist"].as<std::string>());
+	if (vm["path-split"].as<int>() < 0 || vm["path-split"].as<int>() > 16) {
+		std::cout << "Wrong parameter defining the number of branches of --path-split (0 to 16)\n";
+		return 1;
+	}
 
 	if (vm.count("svcomp")) {
 		setMain("main");
@@ -460,6 +596,14 @@ int main(int argc, char* argv[]) {
 		technique = PATH_FOCUSING;
 	}
 
+	if (vm.count("stages")) {
+		if (setStages(vm["stages"].as<std::string>())) return 1;
+		if (technique == LW_WITH_PF_DISJ) {
+			std::cout << "--stages cannot be used with disjunctive invariants\n";
+			return 1;
+		}
+	}
+
 	for (const std::string & tech_str : compare_list) {
 		enum Techniques technique = TechniqueFromString(bad_use, tech_str);
 		TechniquesToCompare.push_back(technique);
@@ -470,3 +614,4 @@ int main(int argc, char* argv[]) {
 	return 0;
 }
 
+#endif
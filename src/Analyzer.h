@@ -46,7 +46,8 @@ enum Apron_Manager_Type {
 	PPL_GRID,
 	PKGRID,
 #endif
-	PKEQ
+	PKEQ,
+	NATIVE_BOX
 };
 
 enum Techniques {
@@ -80,8 +81,11 @@ std::string TechniquesToString(Techniques t);
 enum Techniques TechniqueFromString(bool &error, std::string d);
 
 std::string ApronManagerToString(Apron_Manager_Type D);
+Apron_Manager_Type ApronManagerFromString(bool &error, std::string d);
 
 SMTSolver getSMTSolver();
+// returns true if d is not the name of a solver
+bool setSolver(std::string d);
 
 Techniques getTechnique();
 
@@ -91,6 +95,13 @@ std::vector<enum Techniques> & getComparedTechniques();
 bool compareDomain();
 bool compareNarrowing();
 
+// staged analysis (--stages): each stage uses the invariants of the previous
+// one, with a more expensive abstract domain
+#define MAX_STAGES 4
+bool useStages();
+int getNumStages();
+Apron_Manager_Type getStageDomain(int i);
+
 bool onlyOutputsRho();
 
 // ignores ALL multiplications and divisions
@@ -119,6 +130,8 @@ std::string getFilename();
 
 int getTimeout();
 bool hasTimeout();
+// first time budget of the SMT queries, in milliseconds (0: no budget)
+int getSMTBudget();
 
 bool definedMain();
 std::string getMain();
@@ -126,6 +139,22 @@ bool isMain(llvm::Function * F);
 
 bool quiet_mode();
 bool log_smt_into_file();
+// record the SMT queries for pagai-smt-replay
+bool capture_smt();
+std::string getSMTCaptureFilename();
+// solver given on the command line
+std::string getSMTSolverName();
+// write a timeline of the analysis (--trace)
+bool trace_analysis();
+std::string getTraceFilename();
+// memory telemetry (--memstats, --memstats-interval)
+bool memStats();
+std::string getMemStatsFilename();
+int getMemStatsInterval();
+// save the invariants of each function (--checkpoint), restore them (--resume)
+bool checkpoint_analysis();
+std::string getCheckpointFilename();
+bool resume_analysis();
 bool generateMetadata();
 std::string getAnnotatedBCFilename();
 bool InvariantAsMetadata();
@@ -148,6 +177,25 @@ bool global2local();
 bool loop_rotate();
 bool InstCombining();
 bool dumpll();
+// cache the preprocessed bitcode (--bc-cache)
+bool useBitcodeCache();
+std::string getBitcodeCacheDir();
+
+// statically dispatch the abstract operations of the fixpoint engines
+bool staticDispatch();
+
+// remove the loop headers that are not needed to cut all the cycles
+bool minimizeCutPoints();
+
+// pop the worklist in topological order of the DAG of the SCCs
+bool topologicalWorklist();
+
+// number of branches fixed to split the enumeration of the new paths
+// (--path-split)
+int getPathSplit();
+
+// guard the parts of rho with activation literals, enabled per SMT query
+bool rhoSlices();
 
 // stream used to write the output file
 extern llvm::raw_ostream *Out;
@@ -0,0 +1,170 @@
+/**
+ * \file BitcodeCache.cc
+ * \brief Implementation of the BitcodeCache class
+ * \author agent
+ */
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "config.h"
+
+#include "begin_3rdparty.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Bitcode/ReaderWriter.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/raw_ostream.h"
+#include "end_3rdparty.h"
+
+#include "BitcodeCache.h"
+#include "Analyzer.h"
+#include "Debug.h"
+#include "utilities.h"
+
+using namespace llvm;
+
+static std::string md5_to_string(MD5 & Hash) {
+	MD5::MD5Result Result;
+	Hash.final(Result);
+	SmallString<32> Str;
+	MD5::stringifyResult(Result, Str);
+	return Str.str();
+}
+
+BitcodeCache::BitcodeCache(
+		const std::string & dir,
+		const std::string & InputFilename,
+		const std::vector<const char *> & args) : dir(dir) {
+	MD5 Hash;
+	Hash.update(PAGAI_VERSION);
+	Hash.update(StringRef("\0", 1));
+	// the debug information records the file name and the working
+	// directory
+	SmallString<256> cwd;
+	sys::fs::current_path(cwd);
+	Hash.update(cwd.str());
+	Hash.update(StringRef("\0", 1));
+	Hash.update(InputFilename);
+	Hash.update(StringRef("\0", 1));
+	std::string content;
+	if (hashFile(InputFilename, content)) Hash.update(content);
+	for (const char * arg : args) {
+		Hash.update(StringRef(arg));
+		Hash.update(StringRef("\0", 1));
+	}
+	// options that change the preprocessing passes
+	std::ostringstream flags;
+	flags << check_overflow()
+		<< WCETSettings()
+		<< optimizeBC()
+		<< InstCombining()
+		<< inline_functions()
+		<< global2local()
+		<< loop_rotate()
+		<< brutal_unrolling();
+	Hash.update(flags.str());
+	key = md5_to_string(Hash);
+}
+
+std::string BitcodeCache::path(const std::string & extension) {
+	return dir + "/" + key + extension;
+}
+
+std::string BitcodeCache::getClangDependencyFilename() {
+	return path(".d.tmp");
+}
+
+std::string BitcodeCache::getBitcodeFilename() {
+	return path(".bc");
+}
+
+bool BitcodeCache::hashFile(const std::string & filename, std::string & hash) {
+	std::ifstream in(filename.c_str(), std::ios::binary);
+	if (!in.is_open()) return false;
+	MD5 Hash;
+	char buf[4096];
+	while (in.read(buf, sizeof(buf)) || in.gcount() > 0) {
+		Hash.update(StringRef(buf, in.gcount()));
+	}
+	hash = md5_to_string(Hash);
+	return true;
+}
+
+void BitcodeCache::readMakeDependencies(
+		const std::string & filename,
+		std::vector<std::string> & deps) {
+	std::ifstream in(filename.c_str());
+	utilities::read_make_dependencies(in, deps);
+}
+
+bool BitcodeCache::lookup() {
+	std::ifstream in(path(".deps").c_str());
+	if (!in.is_open()) return false;
+	if (!sys::fs::exists(getBitcodeFilename())) return false;
+	std::string line;
+	while (std::getline(in, line)) {
+		size_t space = line.find(' ');
+		if (space == std::string::npos) return false;
+		std::string hash;
+		if (!hashFile(line.substr(space + 1), hash) || hash != line.substr(0, space))
+			return false;
+	}
+	*Dbg << "// preprocessed bitcode read from " << getBitcodeFilename() << "\n";
+	return true;
+}
+
+void BitcodeCache::store(Module * M, const std::string & InputFilename) {
+	std::vector<std::string> deps;
+	std::string clang_deps = getClangDependencyFilename();
+	readMakeDependencies(clang_deps, deps);
+	std::remove(clang_deps.c_str());
+	if (deps.empty()) deps.push_back(InputFilename);
+
+	sys::fs::create_directories(dir);
+	std::string bc = getBitcodeFilename();
+	std::string bc_tmp = bc + ".tmp";
+	{
+#if LLVM_VERSION_ATLEAST(3, 5)
+		std::error_code error;
+		raw_fd_ostream BitcodeOutput(bc_tmp.c_str(), error, sys::fs::F_None);
+		if (error) {
+#else
+		std::string error_str;
+		raw_fd_ostream BitcodeOutput(bc_tmp.c_str(), error_str, sys::fs::F_None);
+		if (!error_str.empty()) {
+#endif
+			*Dbg << "ERROR: cannot write " << bc_tmp << "\n";
+			return;
+		}
+		WriteBitcodeToFile(M, BitcodeOutput);
+		BitcodeOutput.close();
+		if (BitcodeOutput.has_error()) {
+			BitcodeOutput.clear_error();
+			*Dbg << "ERROR: cannot write " << bc_tmp << "\n";
+			std::remove(bc_tmp.c_str());
+			return;
+		}
+	}
+
+	std::string deps_file = path(".deps");
+	std::string deps_tmp = deps_file + ".tmp";
+	{
+		std::ofstream out(deps_tmp.c_str());
+		for (const std::string & d : deps) {
+			std::string hash;
+			if (!hashFile(d, hash)) {
+				// this entry could never be validated
+				out.close();
+				std::remove(deps_tmp.c_str());
+				std::remove(bc_tmp.c_str());
+				return;
+			}
+			out << hash << " " << d << "\n";
+		}
+	}
+	if (std::rename(bc_tmp.c_str(), bc.c_str()) != 0
+			|| std::rename(deps_tmp.c_str(), deps_file.c_str()) != 0) {
+		*Dbg << "ERROR: cannot write the cache entry " << path("") << "\n";
+	}
+}
@@ -0,0 +1,80 @@
+/**
+ * \file BitcodeCache.h
+ * \brief Declaration of the BitcodeCache class
+ * \author agent
+ */
+#ifndef _BITCODECACHE_H
+#define _BITCODECACHE_H
+
+#include <string>
+#include <vector>
+
+#include "begin_3rdparty.h"
+#include "llvm/IR/Module.h"
+#include "end_3rdparty.h"
+
+/**
+ * \class BitcodeCache
+ * \brief cache of the module obtained after the preprocessing passes
+ * (--bc-cache)
+ *
+ * An entry is identified by a key computed from the input file (its name and
+ * content), the working directory and the options that change the
+ * preprocessing. It is made of two files in the cache directory:
+ * - key.bc, the preprocessed module
+ * - key.deps, the hash of every file the module depends on (the input file
+ *   and the headers it includes, as listed by clang)
+ * An entry is only used if none of its dependencies changed. The .deps file
+ * is written last, so an entry is never read before it is complete.
+ */
+class BitcodeCache {
+
+	private:
+		std::string dir;
+		std::string key;
+
+		std::string path(const std::string & extension);
+
+		/**
+		 * \brief md5 of the content of the file
+		 * \return false if the file cannot be read
+		 */
+		static bool hashFile(const std::string & filename, std::string & hash);
+
+		/**
+		 * \brief reads the dependencies listed in a make rule written by
+		 * clang
+		 */
+		static void readMakeDependencies(
+				const std::string & filename,
+				std::vector<std::string> & deps);
+
+	public:
+		/**
+		 * \param args arguments given to clang
+		 */
+		BitcodeCache(
+				const std::string & dir,
+				const std::string & InputFilename,
+				const std::vector<const char *> & args);
+
+		/**
+		 * \brief file where clang writes the headers included by the
+		 * input file
+		 */
+		std::string getClangDependencyFilename();
+
+		std::string getBitcodeFilename();
+
+		/**
+		 * \brief true if the cache has a valid entry for the input file
+		 */
+		bool lookup();
+
+		/**
+		 * \brief stores the preprocessed module M
+		 */
+		void store(llvm::Module * M, const std::string & InputFilename);
+};
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * \file BlockGraph.cc
+ * \brief Implementation of the BlockGraph class
+ * \author agent
+ */
+#include <algorithm>
+
+#include "begin_3rdparty.h"
+#include "llvm/Analysis/CFG.h"
+#include "end_3rdparty.h"
+
+#include "BlockGraph.h"
+
+using namespace llvm;
+
+BlockGraph::BlockGraph() {
+	succ_offset.push_back(0);
+	pred_offset.push_back(0);
+}
+
+void BlockGraph::init(Function * F) {
+	blocks.clear();
+	ids.clear();
+	for (Function::iterator it = F->begin(), et = F->end(); it != et; ++it) {
+		BasicBlock * b = it;
+		ids[b] = blocks.size();
+		blocks.push_back(b);
+	}
+	std::vector<std::pair<unsigned,unsigned> > edges;
+	setEdges(edges);
+}
+
+void BlockGraph::initCFG(Function * F) {
+	init(F);
+	std::vector<std::pair<unsigned,unsigned> > edges;
+	for (unsigned i = 0; i < blocks.size(); i++) {
+		for (succ_iterator s = succ_begin(blocks[i]), E = succ_end(blocks[i]); s != E; ++s) {
+			edges.push_back(std::make_pair(i, getId(*s)));
+		}
+	}
+	setEdges(edges);
+}
+
+void BlockGraph::fill(
+		const std::vector<std::pair<unsigned,unsigned> > & edges,
+		std::vector<unsigned> & offset,
+		std::vector<BasicBlock*> & target) {
+	offset.assign(blocks.size() + 1, 0);
+	target.clear();
+	target.reserve(edges.size());
+	for (auto & e : edges) {
+		offset[e.first + 1]++;
+		target.push_back(blocks[e.second]);
+	}
+	for (unsigned i = 0; i < blocks.size(); i++) {
+		offset[i + 1] += offset[i];
+	}
+}
+
+void BlockGraph::setEdges(std::vector<std::pair<unsigned,unsigned> > & edges) {
+	std::sort(edges.begin(), edges.end());
+	edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+	fill(edges, succ_offset, succ_target);
+
+	for (auto & e : edges) {
+		std::swap(e.first, e.second);
+	}
+	std::sort(edges.begin(), edges.end());
+	fill(edges, pred_offset, pred_target);
+}
+
+unsigned BlockGraph::getId(BasicBlock * b) const {
+	return ids.lookup(b);
+}
+
+BlockRange BlockGraph::successors(BasicBlock * b) const {
+	DenseMap<BasicBlock*, unsigned>::const_iterator it = ids.find(b);
+	if (it == ids.end()) return BlockRange();
+	return BlockRange(
+			succ_target.data() + succ_offset[it->second],
+			succ_target.data() + succ_offset[it->second + 1]);
+}
+
+BlockRange BlockGraph::predecessors(BasicBlock * b) const {
+	DenseMap<BasicBlock*, unsigned>::const_iterator it = ids.find(b);
+	if (it == ids.end()) return BlockRange();
+	return BlockRange(
+			pred_target.data() + pred_offset[it->second],
+			pred_target.data() + pred_offset[it->second + 1]);
+}
@@ -0,0 +1,121 @@
+/**
+ * \file BlockGraph.h
+ * \brief Declaration of the BlockGraph class
+ * \author agent
+ */
+#ifndef BLOCKGRAPH_H
+#define BLOCKGRAPH_H
+
+#include <utility>
+#include <vector>
+
+#include "begin_3rdparty.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/ADT/DenseMap.h"
+#include "end_3rdparty.h"
+
+/**
+ * \class BlockRange
+ * \brief range of basicblocks stored in a BlockGraph
+ *
+ * The range does not own the blocks: it is invalidated when the graph it
+ * comes from is rebuilt.
+ */
+class BlockRange {
+
+	private:
+		llvm::BasicBlock * const * first;
+		llvm::BasicBlock * const * last;
+
+	public:
+		typedef llvm::BasicBlock * const * iterator;
+
+		BlockRange() : first(NULL), last(NULL) {}
+		BlockRange(iterator b, iterator e) : first(b), last(e) {}
+
+		iterator begin() const {return first;}
+		iterator end() const {return last;}
+		size_t size() const {return last - first;}
+		bool empty() const {return first == last;}
+};
+
+/**
+ * \class BlockGraph
+ * \brief graph over the basicblocks of a function, stored in compressed
+ * sparse row format
+ *
+ * Each basicblock of the function has a dense id, given by its position in
+ * the function. Successors and predecessors are stored in two flat arrays,
+ * sorted by id and without duplicates, and are returned as ranges in these
+ * arrays.
+ */
+class BlockGraph {
+
+	private:
+		std::vector<llvm::BasicBlock*> blocks;
+		llvm::DenseMap<llvm::BasicBlock*, unsigned> ids;
+
+		/**
+		 * \brief the successors of the block of id i are
+		 * succ_target[succ_offset[i] .. succ_offset[i+1][
+		 */
+		std::vector<unsigned> succ_offset;
+		std::vector<llvm::BasicBlock*> succ_target;
+
+		/**
+		 * \brief same layout as succ_offset/succ_target, for the
+		 * predecessors
+		 */
+		std::vector<unsigned> pred_offset;
+		std::vector<llvm::BasicBlock*> pred_target;
+
+		/**
+		 * \brief fills offset and target from the sorted edges
+		 * (source, target), given as pairs of ids
+		 */
+		void fill(
+				const std::vector<std::pair<unsigned,unsigned> > & edges,
+				std::vector<unsigned> & offset,
+				std::vector<llvm::BasicBlock*> & target);
+
+	public:
+		BlockGraph();
+
+		/**
+		 * \brief gives an id to each block of F, the graph has no edges
+		 */
+		void init(llvm::Function * F);
+
+		/**
+		 * \brief the graph becomes the control flow graph of F
+		 */
+		void initCFG(llvm::Function * F);
+
+		/**
+		 * \brief replaces the edges of the graph
+		 * \param edges pairs of ids (source, target), may contain
+		 * duplicates. The vector is sorted by this function.
+		 */
+		void setEdges(std::vector<std::pair<unsigned,unsigned> > & edges);
+
+		/**
+		 * \brief number of blocks in the graph
+		 */
+		unsigned size() const {return blocks.size();}
+
+		/**
+		 * \brief id of a block of the function
+		 */
+		unsigned getId(llvm::BasicBlock * b) const;
+
+		/**
+		 * \brief block of id i
+		 */
+		llvm::BasicBlock * getBlock(unsigned i) const {return blocks[i];}
+
+		BlockRange successors(llvm::BasicBlock * b) const;
+		BlockRange predecessors(llvm::BasicBlock * b) const;
+};
+
+#endif
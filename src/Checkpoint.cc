@@ -0,0 +1,395 @@
+/**
+ * \file Checkpoint.cc
+ * \brief Implementation of the Checkpoint class
+ * \author agent
+ */
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+
+#include "begin_3rdparty.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Bitcode/ReaderWriter.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/raw_ostream.h"
+#include "end_3rdparty.h"
+
+#include "Checkpoint.h"
+#include "Analyzer.h"
+#include "Abstract.h"
+#include "AbstractMan.h"
+#include "Constraint.h"
+#include "Environment.h"
+#include "Expr.h"
+
+using namespace llvm;
+
+#define CHECKPOINT_HEADER "; pagai checkpoint 2"
+
+Checkpoint::Checkpoint() {
+	filename = getCheckpointFilename();
+	out = NULL;
+	loaded = false;
+}
+
+Checkpoint * Checkpoint::getInstance() {
+	static Checkpoint * instance = NULL;
+	if (instance == NULL) instance = new Checkpoint();
+	return instance;
+}
+
+std::string Checkpoint::key(Function * F, params P) {
+	std::ostringstream k;
+	k << F->getName().str() << " " << P.T << " " << P.D << " " << P.N << " " << P.TH;
+	return k.str();
+}
+
+std::string Checkpoint::hashModule(Module * M) {
+	std::string bc;
+	{
+		raw_string_ostream os(bc);
+		WriteBitcodeToFile(M, os);
+	}
+	MD5 Hash;
+	Hash.update(bc);
+	MD5::MD5Result Result;
+	Hash.final(Result);
+	SmallString<32> Str;
+	MD5::stringifyResult(Result, Str);
+	return Str.str();
+}
+
+void Checkpoint::open(Module * M) {
+	if (!bitcode.empty()) return;
+	bitcode = hashModule(M);
+	if (resume_analysis()) loaded = load();
+}
+
+void Checkpoint::numberValues(
+		Function * F,
+		std::vector<Value*> & values,
+		DenseMap<Value*, unsigned> & ids) {
+	for (Function::arg_iterator a = F->arg_begin(), e = F->arg_end(); a != e; ++a) {
+		Value * v = a;
+		ids[v] = values.size();
+		values.push_back(v);
+	}
+	for (Function::iterator b = F->begin(), e = F->end(); b != e; ++b) {
+		for (BasicBlock::iterator i = b->begin(), ie = b->end(); i != ie; ++i) {
+			Value * v = i;
+			ids[v] = values.size();
+			values.push_back(v);
+		}
+	}
+}
+
+static bool scalar_to_string(ap_coeff_t * c, std::string & s) {
+	if (c->discr != AP_COEFF_SCALAR) return false;
+	ap_scalar_t * scalar = c->val.scalar;
+	if (ap_scalar_infty(scalar)) return false;
+	switch (scalar->discr) {
+		case AP_SCALAR_MPQ:
+			{
+				char * str = mpq_get_str(NULL, 10, scalar->val.mpq);
+				s = std::string("q") + str;
+				void (*freefunc)(void *, size_t);
+				mp_get_memory_functions(NULL, NULL, &freefunc);
+				freefunc(str, strlen(str) + 1);
+				return true;
+			}
+		case AP_SCALAR_DOUBLE:
+			{
+				std::ostringstream d;
+				d << "d" << std::setprecision(17) << scalar->val.dbl;
+				s = d.str();
+				return true;
+			}
+		default:
+			return false;
+	}
+}
+
+static bool scalar_from_string(ap_coeff_t * c, const std::string & s) {
+	if (c == NULL || s.size() < 2) return false;
+	if (s[0] == 'q') {
+		mpq_t q;
+		mpq_init(q);
+		bool ok = (mpq_set_str(q, s.c_str() + 1, 10) == 0);
+		if (ok) {
+			mpq_canonicalize(q);
+			ap_coeff_set_scalar_mpq(c, q);
+		}
+		mpq_clear(q);
+		return ok;
+	} else if (s[0] == 'd') {
+		ap_coeff_set_scalar_double(c, atof(s.c_str() + 1));
+		return true;
+	}
+	return false;
+}
+
+/**
+ * \brief writes a linear constraint as
+ * constyp constant nterms (id coeff)*
+ * returns false if it cannot be written exactly: the constraint is then
+ * dropped, which only loses precision
+ */
+static bool write_lincons(
+		std::ostream & out,
+		ap_lincons1_t * c,
+		const DenseMap<Value*, unsigned> & ids) {
+	ap_constyp_t constyp = *ap_lincons1_constypref(c);
+	if (constyp == AP_CONS_EQMOD) return false;
+	ap_linexpr1_t e = ap_lincons1_linexpr1ref(c);
+	std::string cst;
+	if (!scalar_to_string(ap_lincons1_cstref(c), cst)) return false;
+
+	std::ostringstream terms;
+	size_t nterms = 0;
+	size_t i;
+	ap_var_t var;
+	ap_coeff_t * coeff;
+	ap_linexpr1_ForeachLinterm1(&e, i, var, coeff) {
+		if (ap_coeff_zero(coeff)) continue;
+		std::string s;
+		if (!scalar_to_string(coeff, s)) return false;
+		terms << " " << ids.lookup((Value*)var) << " " << s;
+		nterms++;
+	}
+	out << constyp << " " << cst << " " << nterms << terms.str();
+	return true;
+}
+
+bool Checkpoint::writeAbstract(
+		std::ostream & out,
+		Abstract * A,
+		const DenseMap<Value*, unsigned> & ids) {
+	Environment env(A);
+	std::set<ap_var_t> intvars, realvars;
+	env.get_vars(intvars, realvars);
+	std::set<ap_var_t> vars(intvars);
+	vars.insert(realvars.begin(), realvars.end());
+	for (ap_var_t var : vars) {
+		if (Expr::is_undef_ap_var(var) || !ids.count((Value*)var)) return false;
+	}
+
+	bool bottom = A->is_bottom();
+	out << (bottom ? "bottom" : "value") << " " << intvars.size() << " " << realvars.size();
+	for (ap_var_t var : intvars) out << " " << ids.lookup((Value*)var);
+	for (ap_var_t var : realvars) out << " " << ids.lookup((Value*)var);
+	if (bottom) return true;
+
+	ap_lincons1_array_t array = A->to_lincons_array();
+	std::vector<std::string> cons;
+	for (size_t k = 0; k < ap_lincons1_array_size(&array); k++) {
+		ap_lincons1_t c = ap_lincons1_array_get(&array, k);
+		std::ostringstream s;
+		if (write_lincons(s, &c, ids)) cons.push_back(s.str());
+	}
+	ap_lincons1_array_clear(&array);
+	out << " " << cons.size();
+	for (const std::string & c : cons) out << " " << c;
+	return true;
+}
+
+Abstract * Checkpoint::readAbstract(
+		std::istream & in,
+		AbstractMan * aman,
+		ap_manager_t * man,
+		const std::vector<Value*> & values) {
+	std::string kind;
+	size_t nint, nreal;
+	in >> kind >> nint >> nreal;
+	if (!in || (kind != "bottom" && kind != "value")) return NULL;
+	std::set<ap_var_t> intvars, realvars;
+	for (size_t k = 0; k < nint + nreal; k++) {
+		unsigned id;
+		if (!(in >> id) || id >= values.size()) return NULL;
+		if (k < nint) intvars.insert(values[id]);
+		else realvars.insert(values[id]);
+	}
+	Environment env(intvars, realvars);
+	Abstract * A = aman->NewAbstract(man, &env);
+	if (kind == "bottom") {
+		A->set_bottom(&env);
+		return A;
+	}
+	A->set_top(&env);
+
+	size_t ncons;
+	bool ok = (bool)(in >> ncons);
+	Constraint_array cons;
+	for (size_t k = 0; ok && k < ncons; k++) {
+		int constyp;
+		std::string cst;
+		size_t nterms;
+		if (!(in >> constyp >> cst >> nterms)) {
+			ok = false;
+			break;
+		}
+		ap_linexpr1_t e = ap_linexpr1_make(env.getEnv(), AP_LINEXPR_SPARSE, nterms);
+		ok = scalar_from_string(ap_linexpr1_cstref(&e), cst);
+		for (size_t t = 0; ok && t < nterms; t++) {
+			unsigned id;
+			std::string coeff;
+			ok = (in >> id >> coeff) && id < values.size()
+				&& scalar_from_string(ap_linexpr1_coeffref(&e, values[id]), coeff);
+		}
+		if (!ok) {
+			ap_linexpr1_clear(&e);
+			break;
+		}
+		ap_lincons1_t lc = ap_lincons1_make((ap_constyp_t)constyp, &e, NULL);
+		cons.add_constraint(new Constraint(ap_tcons1_from_lincons1(&lc)));
+		ap_lincons1_clear(&lc);
+	}
+	if (!ok) {
+		delete A;
+		return NULL;
+	}
+	if (cons.size() > 0) A->meet_tcons_array(&cons);
+	return A;
+}
+
+bool Checkpoint::load() {
+	std::ifstream in(filename.c_str());
+	if (!in.is_open()) return false;
+	std::string line;
+	if (!std::getline(in, line) || line != CHECKPOINT_HEADER) {
+		*Out << "ERROR: " << filename << " is not a checkpoint file\n";
+		return false;
+	}
+	if (!std::getline(in, line) || line != "bitcode " + bitcode) {
+		*Out << "ERROR: " << filename << " was written for another bitcode, it is ignored\n";
+		return false;
+	}
+	std::string k, record;
+	bool inside = false;
+	while (std::getline(in, line)) {
+		if (line.compare(0, 9, "function ") == 0) {
+			// a record without its end line is dropped
+			k = line.substr(9);
+			record.clear();
+			inside = true;
+		} else if (inside && line == "end") {
+			records[k] = record;
+			inside = false;
+		} else if (inside) {
+			record += line;
+			record += "\n";
+		}
+	}
+	return true;
+}
+
+void Checkpoint::append(const std::string & k, const std::string & record) {
+	if (out == NULL) {
+		if (loaded) {
+			out = new std::ofstream(filename.c_str(), std::ios::app);
+			// the last record may have been cut in the middle of a line
+			*out << "\n";
+		} else {
+			out = new std::ofstream(filename.c_str());
+			*out << CHECKPOINT_HEADER << "\n" << "bitcode " << bitcode << "\n";
+		}
+	}
+	*out << "function " << k << "\n" << record << "end\n";
+	out->flush();
+	if (!*out) {
+		*Out << "ERROR: cannot write the checkpoint file " << filename << "\n";
+	}
+}
+
+void Checkpoint::save(Function * F, params P, Duration time, bool unknown) {
+	open(F->getParent());
+	std::vector<Value*> values;
+	DenseMap<Value*, unsigned> ids;
+	numberValues(F, values, ids);
+
+	std::ostringstream r;
+	r << "time " << std::setprecision(17) << time.count() << "\n";
+	r << "unknown " << unknown << "\n";
+	r << "values " << values.size() << "\n";
+	unsigned index = 0;
+	for (Function::iterator it = F->begin(); it != F->end(); ++it, ++index) {
+		Node * n = Nodes[it];
+		Abstract * X[2] = {
+			n->X_s.count(P) ? n->X_s[P] : NULL,
+			n->X_f.count(P) ? n->X_f[P] : NULL};
+		const char * tag[2] = {"s", "f"};
+		for (int k = 0; k < 2; k++) {
+			if (X[k] == NULL) continue;
+			std::ostringstream a;
+			// this function cannot be saved, it will be analyzed again
+			if (!writeAbstract(a, X[k], ids)) return;
+			r << "block " << index << " " << tag[k] << " " << a.str() << "\n";
+		}
+	}
+
+	append(key(F, P), r.str());
+}
+
+bool Checkpoint::restore(
+		Function * F,
+		params P,
+		AbstractMan * aman,
+		ap_manager_t * man,
+		Duration & time,
+		bool & unknown) {
+	open(F->getParent());
+	std::string k = key(F, P);
+	if (!records.count(k)) return false;
+
+	std::vector<Value*> values;
+	DenseMap<Value*, unsigned> ids;
+	numberValues(F, values, ids);
+	std::vector<BasicBlock*> blocks;
+	for (Function::iterator it = F->begin(); it != F->end(); ++it) {
+		blocks.push_back(it);
+	}
+
+	std::istringstream in(records[k]);
+	std::string field;
+	double t = 0;
+	size_t nvalues = 0;
+	bool u = false;
+	bool ok = (in >> field >> t) && field == "time"
+		&& (in >> field >> u) && field == "unknown"
+		&& (in >> field >> nvalues) && field == "values"
+		&& nvalues == values.size();
+
+	// (block, s or f) -> abstract value
+	std::vector<std::pair<std::pair<BasicBlock*, std::string>, Abstract*> > restored;
+	while (ok && (in >> field)) {
+		unsigned index;
+		std::string tag;
+		ok = field == "block" && (in >> index >> tag) && index < blocks.size()
+			&& (tag == "s" || tag == "f");
+		if (!ok) break;
+		Abstract * A = readAbstract(in, aman, man, values);
+		if (A == NULL) {
+			ok = false;
+			break;
+		}
+		restored.push_back(std::make_pair(std::make_pair(blocks[index], tag), A));
+	}
+	if (!ok) {
+		for (auto & r : restored) delete r.second;
+		*Dbg << "// checkpoint of " << F->getName() << " ignored: it does not match the bitcode\n";
+		return false;
+	}
+
+	for (auto & r : restored) {
+		Node * n = Nodes[r.first.first];
+		Abstract * & X = (r.first.second == "s") ? n->X_s[P] : n->X_f[P];
+		delete X;
+		X = r.second;
+	}
+	time = Duration(t);
+	unknown = u;
+	return true;
+}
@@ -0,0 +1,146 @@
+/**
+ * \file Checkpoint.h
+ * \brief Declaration of the Checkpoint class
+ * \author agent
+ */
+#ifndef _CHECKPOINT_H
+#define _CHECKPOINT_H
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "begin_3rdparty.h"
+#include "ap_global1.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/ADT/DenseMap.h"
+#include "end_3rdparty.h"
+
+#include "Node.h"
+#include "Debug.h"
+
+class Abstract;
+class AbstractMan;
+
+/**
+ * \class Checkpoint
+ * \brief saves the invariants of each analyzed function (--checkpoint) and
+ * restores them in a later run (--resume)
+ *
+ * The file starts with the MD5 hash of the analyzed bitcode, and contains
+ * one record per function and pass, with the X_s and X_f abstract values of
+ * the blocks written as conjunctions of linear constraints with exact
+ * coefficients. Variables are identified by their position in the function
+ * (arguments, then instructions), so a file written for another bitcode is
+ * ignored by --resume.
+ *
+ * A record is appended to the file once the analysis of a function is
+ * done, and a record whose end line is missing is dropped when the file is
+ * read, so a run killed at any time leaves the records of all the functions
+ * it has finished. The worklist of the function being analyzed is not
+ * saved: this function is analyzed again from the start.
+ */
+class Checkpoint {
+
+	private:
+		/**
+		 * \brief records read from the file, indexed by their key
+		 */
+		std::map<std::string, std::string> records;
+
+		std::string filename;
+
+		/**
+		 * \brief hash of the bitcode, computed on the first save or restore
+		 */
+		std::string bitcode;
+
+		/**
+		 * \brief file the records are appended to, opened on the first save
+		 */
+		std::ofstream * out;
+
+		/**
+		 * \brief true if the existing file matches the bitcode, the records
+		 * of this run are then appended to it
+		 */
+		bool loaded;
+
+		Checkpoint();
+
+		static std::string key(llvm::Function * F, params P);
+
+		/**
+		 * \brief MD5 hash of the bitcode of M
+		 */
+		static std::string hashModule(llvm::Module * M);
+
+		/**
+		 * \brief computes the hash of the bitcode and reads the file with
+		 * --resume, the first time it is called
+		 */
+		void open(llvm::Module * M);
+
+		/**
+		 * \brief values of the function: arguments, then instructions
+		 */
+		static void numberValues(
+				llvm::Function * F,
+				std::vector<llvm::Value*> & values,
+				llvm::DenseMap<llvm::Value*, unsigned> & ids);
+
+		/**
+		 * \brief writes the abstract value, returns false if one of its
+		 * variables is not a value of the function
+		 */
+		static bool writeAbstract(
+				std::ostream & out,
+				Abstract * A,
+				const llvm::DenseMap<llvm::Value*, unsigned> & ids);
+
+		/**
+		 * \brief reads an abstract value written by writeAbstract, returns
+		 * NULL if the record is malformed
+		 */
+		static Abstract * readAbstract(
+				std::istream & in,
+				AbstractMan * aman,
+				ap_manager_t * man,
+				const std::vector<llvm::Value*> & values);
+
+		/**
+		 * \brief reads the records of the file
+		 * \return false if the file does not exist or does not match the
+		 * bitcode
+		 */
+		bool load();
+
+		/**
+		 * \brief appends the record k to the file
+		 */
+		void append(const std::string & k, const std::string & record);
+
+	public:
+		static Checkpoint * getInstance();
+
+		/**
+		 * \brief saves the abstract values of F for the pass P
+		 */
+		void save(llvm::Function * F, params P, Duration time, bool unknown);
+
+		/**
+		 * \brief restores the abstract values of F for the pass P
+		 * \return false if F has no valid record, then nothing is changed
+		 */
+		bool restore(
+				llvm::Function * F,
+				params P,
+				AbstractMan * aman,
+				ap_manager_t * man,
+				Duration & time,
+				bool & unknown);
+};
+
+#endif
@@ -3,7 +3,11 @@
  * \brief Implementation of the Compare class
  * \author Julien Henry
  */
+#include <cstring>
+
 #include "Compare.h"
+#include "AbstractClassic.h"
+#include "AbstractInterval.h"
 #include "Pr.h"
 #include "Expr.h"
 #include "AIpf.h"
@@ -68,6 +72,35 @@ void Compare::getAnalysisUsage(AnalysisUsage &AU) const {
 	AU.setPreservesAll();
 }
 
+bool Compare::compareSameDomain(Abstract * A, Abstract * B, bool & f, bool & g) {
+	if (!A->has_same_environment(B)) return false;
+
+	if (dynamic_cast<AbstractInterval*>(A) && dynamic_cast<AbstractInterval*>(B)) {
+		f = !A->is_leq(B);
+		g = !B->is_leq(A);
+		return true;
+	}
+
+	// the two passes have their own apron manager, but the values can be
+	// compared by apron if the managers come from the same library
+	if (dynamic_cast<AbstractClassic*>(A) && dynamic_cast<AbstractClassic*>(B)
+		&& !strcmp(ap_manager_get_library(A->man), ap_manager_get_library(B->man))) {
+		f = !ap_abstract1_is_leq(A->man, A->main, B->main);
+		g = !ap_abstract1_is_leq(A->man, B->main, A->main);
+		return true;
+	}
+
+	// lookahead widening and disjunctive values
+	int res;
+	if (!strcmp(ap_manager_get_library(A->man), ap_manager_get_library(B->man))
+		&& A->compare_in_domain(B, res)) {
+		f = (res == -1 || res == -2);
+		g = (res == 1 || res == -2);
+		return true;
+	}
+	return false;
+}
+
 int Compare::compareAbstract(SMTpass * LSMT, Abstract * A, Abstract * B) {
 	bool f = false;
 	bool g = false;
@@ -80,30 +113,15 @@ int Compare::compareAbstract(SMTpass * LSMT, Abstract * A, Abstract * B) {
 	A->change_environment(&cenv);
 	B->change_environment(&cenv);
 
-	LSMT->push_context();
-	SMT_expr A_smt = LSMT->AbstractToSmt(NULL,A);
-	SMT_expr B_smt = LSMT->AbstractToSmt(NULL,B);
-
-	LSMT->push_context();
-	// f = A and not B
-	std::vector<SMT_expr> cunj;
-	cunj.push_back(A_smt);
-	cunj.push_back(LSMT->man->SMT_mk_not(B_smt));
-	SMT_expr test = LSMT->man->SMT_mk_and(cunj);
-	if (LSMT->SMTsolve_simple(test)) {
-		f = true;
-	}
-	LSMT->pop_context();
-
-	// g = B and not A
-	cunj.clear();
-	cunj.push_back(B_smt);
-	cunj.push_back(LSMT->man->SMT_mk_not(A_smt));
-	test = LSMT->man->SMT_mk_and(cunj);
-	if (LSMT->SMTsolve_simple(test)) {
-		g = true;
-	}
-	LSMT->pop_context();
+	// an inclusion proved in the domain also holds for the SMT solver. A
+	// non-inclusion may not, since the solver reasons on the integers: it
+	// is checked by the solver, so that the results are the ones of the
+	// SMT comparison
+	bool check_f = true;
+	bool check_g = true;
+	if (compareSameDomain(A, B, check_f, check_g))
+		abstract_compare_native += !check_f + !check_g;
+	compareSMT(LSMT, A, B, check_f, check_g, f, g);
 
 	if (!f && !g) {
 		return 0;
@@ -123,6 +141,47 @@ int Compare::compareAbstract(SMTpass * LSMT, Abstract * A, Abstract * B) {
 	}
 }
 
+void Compare::compareSMT(
+		SMTpass * LSMT,
+		Abstract * A,
+		Abstract * B,
+		bool check_f,
+		bool check_g,
+		bool & f,
+		bool & g) {
+	if (!check_f && !check_g) return;
+	abstract_compare_smt += check_f + check_g;
+	LSMT->push_context();
+	SMT_expr A_smt = LSMT->AbstractToSmt(NULL,A);
+	SMT_expr B_smt = LSMT->AbstractToSmt(NULL,B);
+	std::vector<SMT_expr> cunj;
+	SMT_expr test;
+
+	if (check_f) {
+		LSMT->push_context();
+		// f = A and not B
+		cunj.push_back(A_smt);
+		cunj.push_back(LSMT->man->SMT_mk_not(B_smt));
+		test = LSMT->man->SMT_mk_and(cunj);
+		if (LSMT->SMTsolve_simple(test)) {
+			f = true;
+		}
+		LSMT->pop_context();
+	}
+
+	if (check_g) {
+		// g = B and not A
+		cunj.clear();
+		cunj.push_back(B_smt);
+		cunj.push_back(LSMT->man->SMT_mk_not(A_smt));
+		test = LSMT->man->SMT_mk_and(cunj);
+		if (LSMT->SMTsolve_simple(test)) {
+			g = true;
+		}
+	}
+	LSMT->pop_context();
+}
+
 void Compare::compareTechniques(Node * n, Techniques t1, Techniques t2) {
 
 	params P1, P2;
@@ -311,6 +370,9 @@ void Compare::CountNumberOfWarnings(Techniques t, Function * F) {
 			}
 		}
 	}
+	// checks discharged after the analysis
+	Warnings[t] += ub_checks[P][F] - ub_checks_proved[P][F];
+	Safe_properties[t] += ub_checks_proved[P][F];
 }
 
 bool Compare::runOnModule(Module &M) {
@@ -35,12 +35,40 @@ class CmpResults {
 /**
  * \class Compare
  * \brief Pass that compares abstract values computed by each AI pass
+ *
+ * The compared passes are run one after another by the PassManager: they
+ * are not run concurrently.
  */
 class Compare : public llvm::ModulePass {
 
 	public:
 		static int compareAbstract(SMTpass * LSMT, Abstract * A, Abstract * B);
 
+	private:
+		/**
+		 * \brief inclusion tests done in the abstract domain, when A and B
+		 * are values of the same domain and environment
+		 * \param f set to true iff A is not included in B in the domain
+		 * \param g set to true iff B is not included in A in the domain
+		 * \return false if the domains differ: the SMT solver has to be used
+		 */
+		static bool compareSameDomain(Abstract * A, Abstract * B, bool & f, bool & g);
+
+		/**
+		 * \brief inclusion tests done with the SMT solver, only for the
+		 * directions given by check_f and check_g
+		 * \param f set to true iff A is not included in B
+		 * \param g set to true iff B is not included in A
+		 */
+		static void compareSMT(
+				SMTpass * LSMT,
+				Abstract * A,
+				Abstract * B,
+				bool check_f,
+				bool check_g,
+				bool & f,
+				bool & g);
+
 	private:
 		std::vector<Techniques> ComparedTechniques;
 
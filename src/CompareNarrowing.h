@@ -151,6 +151,9 @@ void CompareNarrowing<T>::CountNumberOfWarnings(params P, llvm::Function * F) {
 			}
 		}
 	}
+	// checks discharged after the analysis
+	Warnings[P] += ub_checks[P][F] - ub_checks_proved[P][F];
+	Safe_properties[P] += ub_checks_proved[P][F];
 }
 
 template<Techniques T>
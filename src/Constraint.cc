@@ -22,6 +22,10 @@ Constraint::Constraint(ap_constyp_t constyp, Expr * expr, ap_scalar_t* scalar) {
 	free(exp);
 }
 
+Constraint::Constraint(ap_tcons1_t cons) {
+	ap_cons = cons;
+}
+
 Constraint::~Constraint() {
 	ap_tcons1_clear(&ap_cons);
 }
@@ -26,6 +26,11 @@ class Constraint {
 	public:
 		Constraint(ap_constyp_t constyp, Expr * expr, ap_scalar_t* scalar);
 
+		/**
+		 * \brief takes the ownership of cons
+		 */
+		Constraint(ap_tcons1_t cons);
+
 		~Constraint();
 
 		ap_tcons1_t * get_ap_tcons1();
@@ -16,7 +16,24 @@ std::map<params, std::map<llvm::Function*, Duration> > Total_time_SMT;
 
 std::map<params, std::map<llvm::Function*, int> > asc_iterations;
 std::map<params, std::map<llvm::Function*, int> > desc_iterations;
-
+std::map<params, std::map<llvm::Function*, int> > smt_queries;
+std::map<params, std::map<llvm::Function*, int> > smt_query_assertions;
+std::map<params, std::map<llvm::Function*, unsigned long> > smt_pipe_bytes;
+std::map<params, std::map<llvm::Function*, Duration> > Total_time_SMT_parse;
+
+unsigned long abstract_compare_smt = 0;
+unsigned long abstract_compare_native = 0;
+std::map<params, std::map<llvm::Function*, unsigned long> > compare_smt_queries;
+std::map<params, std::map<llvm::Function*, unsigned long> > compare_smt_avoided;
+
+unsigned long smt_retries_count = 0;
+unsigned long smt_escalations_count = 0;
+std::map<params, std::map<llvm::Function*, unsigned long> > smt_retries;
+std::map<params, std::map<llvm::Function*, unsigned long> > smt_escalations;
+
+std::map<params, std::set<llvm::Function*> > stage_skipped;
+std::map<params, std::map<llvm::Function*, int> > ub_checks;
+std::map<params, std::map<llvm::Function*, int> > ub_checks_proved;
 std::map<params, std::set<llvm::Function*> > ignoreFunction;
 std::map<llvm::Function*, int> numNarrowingSeedsInFunction;
 
@@ -58,6 +58,62 @@ extern std::map<params,std::map<llvm::Function*,int> > asc_iterations;
  */
 extern std::map<params,std::map<llvm::Function*,int> > desc_iterations;
 
+/**
+ * \brief count the number of formulas built by createSMTformula
+ */
+extern std::map<params,std::map<llvm::Function*,int> > smt_queries;
+
+/**
+ * \brief count the top-level conjuncts of the formulas built by
+ * createSMTformula
+ */
+extern std::map<params,std::map<llvm::Function*,int> > smt_query_assertions;
+
+/**
+ * \brief bytes exchanged with the pipe solvers, and time spent parsing
+ * their replies
+ */
+extern std::map<params,std::map<llvm::Function*,unsigned long> > smt_pipe_bytes;
+extern std::map<params, std::map<llvm::Function*, Duration> > Total_time_SMT_parse;
+
+/**
+ * \brief SMT queries made when comparing abstract values, and SMT queries
+ * avoided because the abstract domain could compare the values itself
+ *
+ * The global counters are never reset, the maps give their increase during
+ * the analysis of each function.
+ */
+extern unsigned long abstract_compare_smt;
+extern unsigned long abstract_compare_native;
+extern std::map<params,std::map<llvm::Function*,unsigned long> > compare_smt_queries;
+extern std::map<params,std::map<llvm::Function*,unsigned long> > compare_smt_avoided;
+
+/**
+ * \brief SMT checks made again with a larger budget after an unknown answer,
+ * and SMT path queries that directly started with a larger budget because
+ * their source needed it before (see SMTpass::SMT_check)
+ *
+ * As for abstract_compare_smt, the maps give the increase of the global
+ * counters during the analysis of each function.
+ */
+extern unsigned long smt_retries_count;
+extern unsigned long smt_escalations_count;
+extern std::map<params,std::map<llvm::Function*,unsigned long> > smt_retries;
+extern std::map<params,std::map<llvm::Function*,unsigned long> > smt_escalations;
+
+/**
+ * \brief with --stages, functions for which a stage took the invariants of
+ * the previous stage without analyzing them again
+ */
+extern std::map<params,std::set<llvm::Function*> > stage_skipped;
+
+/**
+ * \brief undefined behaviour checks discharged after the analysis (see
+ * ExtractChecks), and those proved safe
+ */
+extern std::map<params,std::map<llvm::Function*,int> > ub_checks;
+extern std::map<params,std::map<llvm::Function*,int> > ub_checks_proved;
+
 /**
  * \brief Functions ignored by Compare pass (because the analysis failed for
  * one technique)
@@ -4,9 +4,12 @@
  * \author Julien Henry
  */
 #include <fstream>
+#include <memory>
 #include <vector>
 #include <cstdlib>
 
+#include <unistd.h>
+
 #include "config.h"
 
 #include "begin_3rdparty.h"
@@ -62,9 +65,11 @@
 #include "Compare.h"
 #include "CompareDomain.h"
 #include "CompareNarrowing.h"
+#include "Stages.h"
 #include "Analyzer.h"
 #include "GenerateSMT.h"
 #include "instrOverflow.h"
+#include "ExtractChecks.h"
 #include "globaltolocal.h"
 #include "taginline.h"
 #include "RemoveUndet.h"
@@ -72,6 +77,10 @@
 #include "expandassume.h"
 #include "NameAllValues.h"
 #include "IdentifyLoops.h"
+#include "Trace.h"
+#include "MemStats.h"
+#include "BitcodeCache.h"
+#include "Output.h"
 
 using namespace llvm;
 
@@ -151,6 +160,91 @@ std::string parse_conf() {
 	return "";
 }
 
+/**
+ * \brief runs the passes that prepare the module for the analysis
+ */
+static void preprocess(Module & M) {
+	// Build up all of the passes that we want to do to the module.
+	PassManager InitialPasses;
+
+	if (!WCETSettings())
+		InitialPasses.add(new RemoveUndet());
+	if (optimizeBC()) {
+		// may degrade precision of the analysis
+		PassManagerBuilder Builder;
+		Builder.OptLevel = 3;
+		Builder.populateModulePassManager(InitialPasses);
+	}
+
+	FunctionPass *LoopInfoPass = new LoopInfo();
+
+	InitialPasses.add(createGCLoweringPass());
+
+	// this pass converts SwitchInst instructions into a sequence of
+	// binary branch instructions, easier to deal with
+	InitialPasses.add(createLowerSwitchPass());
+	InitialPasses.add(createLowerInvokePass());
+	InitialPasses.add(LoopInfoPass);
+	InitialPasses.add(new ExpandAssume());
+	if (InstCombining()) {
+		InitialPasses.add(createInstructionCombiningPass());
+	}
+	if (!WCETSettings()) {
+		InitialPasses.add(new ExpandEqualities());
+	}
+	//Passes.add(createLoopSimplifyPass());
+
+	// in case we want to run an Alias analysis pass :
+	//Passes.add(createGlobalsModRefPass());
+	//Passes.add(createBasicAliasAnalysisPass());
+	//Passes.add(createScalarEvolutionAliasAnalysisPass());
+	//Passes.add(createTypeBasedAliasAnalysisPass());
+	//
+	TagInline * taginlinepass = new TagInline();
+	if (inline_functions()) {
+		InitialPasses.add(taginlinepass); // this pass has to be run before the internalizepass, since it builds the list of functions to analyze
+	}
+
+	if (check_overflow()) {
+		InitialPasses.add(new instrOverflow());
+		InitialPasses.add(new ExtractChecks());
+	}
+
+	InitialPasses.add(new NameAllValues());
+
+	// make sure everything is run before AI analysis
+	InitialPasses.run(M);
+	if (inline_functions()) {
+		PassManager InlinePasses;
+		InlinePasses.add(llvm::createAlwaysInlinerPass());
+		InlinePasses.add(createInternalizePass(TagInline::GetFunctionsToAnalyze()));
+		InlinePasses.add(createGlobalDCEPass());
+		InlinePasses.add(createGlobalOptimizerPass());
+		InlinePasses.run(M);
+	}
+
+	PassManager OptPasses;
+
+	if (global2local())
+	  OptPasses.add(new GlobalToLocal());
+
+	if (loop_rotate())
+	  OptPasses.add(createLoopRotatePass());
+
+	if (!WCETSettings())
+		OptPasses.add(new RemoveUndet());
+
+	if (brutal_unrolling()) {
+		OptPasses.add(createLoopSimplifyPass());
+		OptPasses.add(createLCSSAPass());
+		OptPasses.add(createIndVarSimplifyPass());
+		OptPasses.add(createScalarReplAggregatesPass());
+		//OptPasses.add(createLoopUnrollPass(INT_MAX,INT_MAX,1,0));
+	}
+	OptPasses.add(createPromoteMemoryToRegisterPass());
+	OptPasses.run(M);
+}
+
 void execute::exec(const std::string & InputFilename, const std::string & OutputFilename, const std::vector<std::string> & IncludePaths) {
 
 	raw_fd_ostream *FDOut = NULL;
@@ -175,12 +269,15 @@ void execute::exec(const std::string & InputFilename, const std::string & Output
 		// Make sure that the Output file gets unlinked from the disk if we get a
 		// SIGINT
 		//sys::RemoveFileOnSignal(sys::Path(OutputFilename));
-	} else {
-		Out = &llvm::outs();
-		Out->SetUnbuffered();
+	}
+	// the standard output is written once per function, see OutputSink;
+	// what is not committed yet is written when exec returns
+	std::unique_ptr<OutputSink> StdOut(new OutputSink(STDOUT_FILENO));
+	if (FDOut == NULL) {
+		Out = StdOut.get();
 	}
 	//Dbg = &llvm::fdbgs();
-	Dbg = &llvm::outs();
+	Dbg = StdOut.get();
 
 #if LLVM_VERSION_ATLEAST(3, 5)
 	std::unique_ptr<llvm::Module> M;
@@ -240,6 +337,16 @@ void execute::exec(const std::string & InputFilename, const std::string & Output
 #endif
 	clang::CompilerInvocation::CreateFromArgs(*CI, &args[0], &args[0] + args.size(), *Diags);
 
+	BitcodeCache * cache = NULL;
+	if (useBitcodeCache()) {
+		cache = new BitcodeCache(getBitcodeCacheDir(), InputFilename, args);
+		// clang lists the included headers, so that the cache entry is
+		// invalidated when one of them changes
+		CI->getDependencyOutputOpts().OutputFile = cache->getClangDependencyFilename();
+		CI->getDependencyOutputOpts().Targets.push_back("pagai");
+		CI->getDependencyOutputOpts().IncludeSystemHeaders = 1;
+	}
+
 	clang::CompilerInstance Clang;
 	// equivalent to the -gcolumn-info command line option for clang
 	CI->getCodeGenOpts().DebugColumnInfo = 1;
@@ -268,7 +375,19 @@ void execute::exec(const std::string & InputFilename, const std::string & Output
 
 	*Dbg << "// ResourceDir is " << Clang.getHeaderSearchOpts().ResourceDir << "\n";
 
-	if (!is_Cfile(InputFilename)) {
+	bool cached = false;
+	if (cache != NULL && cache->lookup()) {
+		SMDiagnostic SM;
+#if LLVM_VERSION_ATLEAST(3, 5)
+		M = parseIRFile(cache->getBitcodeFilename(), SM, getGlobalContext());
+#else
+		M = ParseIRFile(cache->getBitcodeFilename(), SM, getGlobalContext());
+#endif
+		cached = (M != NULL);
+	}
+	if (cached) {
+		// already preprocessed
+	} else if (!is_Cfile(InputFilename)) {
 		SMDiagnostic SM;
 		LLVMContext & Context = getGlobalContext();
 // the name "ParseIRFile" has been uncapitalized after LLVM 3.4...
@@ -297,83 +416,16 @@ void execute::exec(const std::string & InputFilename, const std::string & Output
 	PassRegistry &Registry = *PassRegistry::getPassRegistry();
 	initializeAnalysis(Registry);
 
-	// Build up all of the passes that we want to do to the module.
-	PassManager InitialPasses;
-	PassManager AnalysisPasses;
-
-	if (!WCETSettings())
-		InitialPasses.add(new RemoveUndet());
-	if (optimizeBC()) {
-		// may degrade precision of the analysis
-		PassManagerBuilder Builder;
-		Builder.OptLevel = 3;
-		Builder.populateModulePassManager(InitialPasses);
-	}
-
-	FunctionPass *LoopInfoPass = new LoopInfo();
-
-	InitialPasses.add(createGCLoweringPass());
-
-	// this pass converts SwitchInst instructions into a sequence of
-	// binary branch instructions, easier to deal with
-	InitialPasses.add(createLowerSwitchPass());
-	InitialPasses.add(createLowerInvokePass());
-	InitialPasses.add(LoopInfoPass);
-	InitialPasses.add(new ExpandAssume());
-	if (InstCombining()) {
-		InitialPasses.add(createInstructionCombiningPass());
-	}
-	if (!WCETSettings()) {
-		InitialPasses.add(new ExpandEqualities());
-	}
-	//Passes.add(createLoopSimplifyPass());
-
-	// in case we want to run an Alias analysis pass :
-	//Passes.add(createGlobalsModRefPass());
-	//Passes.add(createBasicAliasAnalysisPass());
-	//Passes.add(createScalarEvolutionAliasAnalysisPass());
-	//Passes.add(createTypeBasedAliasAnalysisPass());
-	//
-	TagInline * taginlinepass = new TagInline();
-	if (inline_functions()) {
-		InitialPasses.add(taginlinepass); // this pass has to be run before the internalizepass, since it builds the list of functions to analyze
-	}
-
-	if (check_overflow()) InitialPasses.add(new instrOverflow());
-
-	InitialPasses.add(new NameAllValues());
-
-	// make sure everything is run before AI analysis
-	InitialPasses.run(*M);
-	if (inline_functions()) {
-		PassManager InlinePasses;
-		InlinePasses.add(llvm::createAlwaysInlinerPass());
-		InlinePasses.add(createInternalizePass(TagInline::GetFunctionsToAnalyze()));
-		InlinePasses.add(createGlobalDCEPass());
-		InlinePasses.add(createGlobalOptimizerPass());
-		InlinePasses.run(*M);
+	if (!cached) {
+		preprocess(*M);
+#if LLVM_VERSION_ATLEAST(3, 5)
+		if (cache != NULL) cache->store(M.get(), InputFilename);
+#else
+		if (cache != NULL) cache->store(M, InputFilename);
+#endif
 	}
 
-	PassManager OptPasses;
-
-	if (global2local())
-	  OptPasses.add(new GlobalToLocal());
-
-	if (loop_rotate())
-	  OptPasses.add(createLoopRotatePass());
-
-	if (!WCETSettings())
-		OptPasses.add(new RemoveUndet());
-
-	if (brutal_unrolling()) {
-		OptPasses.add(createLoopSimplifyPass());
-		OptPasses.add(createLCSSAPass());
-		OptPasses.add(createIndVarSimplifyPass());
-		OptPasses.add(createScalarReplAggregatesPass());
-		//OptPasses.add(createLoopUnrollPass(INT_MAX,INT_MAX,1,0));
-	}
-	OptPasses.add(createPromoteMemoryToRegisterPass());
-	OptPasses.run(*M);
+	PassManager AnalysisPasses;
 
 	if (dumpll()) {
 		*Out << *M;
@@ -438,6 +490,13 @@ void execute::exec(const std::string & InputFilename, const std::string & Output
 				AnalysisPasses.add(new CompareDomain<LW_WITH_PF_DISJ>());
 				break;
 		}
+	} else if (useStages()) {
+		for (int i = 0; i < getNumStages(); i++) {
+			ModulePass * StagePass = Stages::createStagePass(getTechnique(), i);
+			assert(StagePass != nullptr);
+			AnalysisPasses.add(StagePass);
+		}
+		AnalysisPasses.add(new Stages());
 	} else {
 		ModulePass *AIPass = nullptr;
 		switch (getTechnique()) {
@@ -469,7 +528,11 @@ void execute::exec(const std::string & InputFilename, const std::string & Output
 		assert(AIPass != nullptr);
 		AnalysisPasses.add(AIPass);
 	}
+	if (trace_analysis()) Trace::start(getTraceFilename());
+	if (memStats()) MemStats::start(getMemStatsInterval());
 	AnalysisPasses.run(*M);
+	if (trace_analysis()) Trace::finish();
+	if (memStats()) MemStats::write(getMemStatsFilename());
 
 #if LLVM_VERSION_ATLEAST(3, 5)
 	std::error_code error;
@@ -496,6 +559,7 @@ void execute::exec(const std::string & InputFilename, const std::string & Output
 	}
 #endif
 
+	delete cache;
 	Pr::releaseMemory();
 	SMTpass::releaseMemory();
 	Expr::clear_exprs();
@@ -42,6 +42,10 @@ void Expr::clear_exprs() {
 	Exprs_var.clear();
 }
 
+size_t Expr::num_exprs() {
+	return Exprs.size() + Exprs_var.size();
+}
+
 ap_texpr1_t * Expr::create_expression(Value * val) {
 	ap_expr = NULL;
 
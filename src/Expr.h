@@ -79,6 +79,11 @@ class Expr : public llvm::InstVisitor<Expr,ap_texpr1_t*> {
 		 */
 		static void clear_exprs();
 
+		/**
+		 * \brief number of expressions stored in the internal maps
+		 */
+		static size_t num_exprs();
+
 		/**
 		 * \brief create a constraint and insert it into t_cons
 		 */
@@ -0,0 +1,121 @@
+/**
+ * \file ExtractChecks.cc
+ * \brief Implementation of the ExtractChecks pass
+ * \author agent
+ */
+#include <vector>
+
+#include "begin_3rdparty.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
+#include "end_3rdparty.h"
+
+#include "ExtractChecks.h"
+
+using namespace llvm;
+
+static const char * const check_function = "__pagai_check";
+static const char * const overflow_handler = "__assert_fail_overflow";
+
+static StringRef getCalledName(CallInst * c) {
+	Value * called = c->getCalledValue()->stripPointerCasts();
+	if (Function * f = dyn_cast<Function>(called))
+		return f->getName();
+	return StringRef();
+}
+
+bool ExtractChecks::isCheck(CallInst * c) {
+	return getCalledName(c) == check_function;
+}
+
+Value * ExtractChecks::getCheckCondition(CallInst * c) {
+	return c->getArgOperand(0);
+}
+
+BasicBlock * ExtractChecks::getHandlerContinuation(BasicBlock * h) {
+	BranchInst * br = dyn_cast<BranchInst>(h->getTerminator());
+	if (br == NULL || br->isConditional()) return NULL;
+	BasicBlock * cont = br->getSuccessor(0);
+	if (cont == h) return NULL;
+
+	bool handler = false;
+	for (BasicBlock::iterator it = h->begin(); it != h->end(); ++it) {
+		Instruction * I = it;
+		if (I == br) break;
+		if (CallInst * c = dyn_cast<CallInst>(I)) {
+			if (getCalledName(c) == overflow_handler) {
+				handler = true;
+				continue;
+			}
+		}
+		// the other instructions compute the arguments of the handler
+		if (isa<PHINode>(I) || I->mayHaveSideEffects() || I->isUsedOutsideOfBlock(h))
+			return NULL;
+	}
+	return handler ? cont : NULL;
+}
+
+bool ExtractChecks::extractCheck(BasicBlock * h) {
+	BasicBlock * cont = getHandlerContinuation(h);
+	if (cont == NULL) return false;
+	BasicBlock * pred = h->getSinglePredecessor();
+	if (pred == NULL || pred == h) return false;
+	BranchInst * br = dyn_cast<BranchInst>(pred->getTerminator());
+	if (br == NULL || br->isUnconditional()) return false;
+
+	bool fail_if_true;
+	if (br->getSuccessor(0) == h && br->getSuccessor(1) == cont) {
+		fail_if_true = true;
+	} else if (br->getSuccessor(1) == h && br->getSuccessor(0) == cont) {
+		fail_if_true = false;
+	} else {
+		return false;
+	}
+	Value * fail = br->getCondition();
+	DebugLoc loc = h->getFirstNonPHI()->getDebugLoc();
+
+	// the handler falls through to cont, so that pred always goes to cont
+	BranchInst * newbr = BranchInst::Create(cont, br);
+	newbr->setDebugLoc(br->getDebugLoc());
+	br->eraseFromParent();
+	DeleteDeadBlock(h);
+
+	// if cont is only reached from pred, the check is placed at its
+	// beginning, so that it is displayed at the position of the checked
+	// operation in the annotated code
+	Instruction * pos = newbr;
+	if (cont->getSinglePredecessor() == pred)
+		pos = &*cont->getFirstInsertionPt();
+
+	if (!fail_if_true)
+		fail = BinaryOperator::CreateNot(fail, "", pos);
+
+	Module * M = pred->getParent()->getParent();
+	LLVMContext & C = M->getContext();
+	std::vector<Type*> args(1, Type::getInt1Ty(C));
+	FunctionType * ftype = FunctionType::get(Type::getVoidTy(C), args, false);
+	Constant * check_func = M->getOrInsertFunction(check_function, ftype);
+	CallInst * check = CallInst::Create(check_func, fail, "", pos);
+	check->setDebugLoc(loc);
+	return true;
+}
+
+bool ExtractChecks::runOnFunction(Function &F) {
+	// the CFG is modified, so we first collect the candidate handlers
+	std::vector<BasicBlock*> handlers;
+	for (Function::iterator i = F.begin(); i != F.end(); ++i) {
+		BasicBlock * b = i;
+		if (b != &F.getEntryBlock() && getHandlerContinuation(b) != NULL)
+			handlers.push_back(b);
+	}
+
+	bool changed = false;
+	for (BasicBlock * h : handlers) {
+		if (extractCheck(h)) changed = true;
+	}
+	return changed;
+}
+
+char ExtractChecks::ID = 0;
+static RegisterPass<ExtractChecks> X("extractchecks", "Undefined behaviour checks extraction", false, false);
@@ -0,0 +1,59 @@
+/**
+ * \file ExtractChecks.h
+ * \brief LLVM pass that moves the undefined behaviour checks out of the CFG
+ * \author agent
+ */
+#ifndef _EXTRACTCHECKS_H
+#define _EXTRACTCHECKS_H
+
+#include "begin_3rdparty.h"
+#include "llvm/Pass.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "end_3rdparty.h"
+
+/**
+ * \class ExtractChecks
+ * \brief replaces the branches to the undefined behaviour handlers by calls
+ * to __pagai_check
+ *
+ * instrOverflow makes each checked operation branch to a block calling
+ * __assert_fail_overflow, that falls through to the continuation. Such a
+ * block would be a block of Pr. This pass removes it, and inserts instead
+ * a call __pagai_check(fail), where fail is the condition under which the
+ * handler was reached. These calls do not split the CFG: they are checked
+ * once the invariants are computed (see AIPass::dischargeChecks).
+ *
+ * Handlers that do not return (llvm.trap followed by unreachable) are left
+ * in the CFG, since they also restrict the states after the check.
+ */
+class ExtractChecks : public llvm::FunctionPass {
+
+	private:
+		/**
+		 * \brief returns the continuation of the handler h, or NULL if h is
+		 * not a handler that can be removed
+		 */
+		llvm::BasicBlock * getHandlerContinuation(llvm::BasicBlock * h);
+
+		bool extractCheck(llvm::BasicBlock * h);
+
+	public:
+		static char ID;
+
+		ExtractChecks() : llvm::FunctionPass(ID) {}
+
+		/**
+		 * \brief returns true iff c is a call to __pagai_check
+		 */
+		static bool isCheck(llvm::CallInst * c);
+
+		/**
+		 * \brief the condition under which the check fails
+		 */
+		static llvm::Value * getCheckCondition(llvm::CallInst * c);
+
+		bool runOnFunction(llvm::Function &F);
+};
+
+#endif
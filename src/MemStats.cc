@@ -0,0 +1,157 @@
+/**
+ * \file MemStats.cc
+ * \brief Implementation of the MemStats class
+ * \author agent
+ */
+#include <cstdio>
+#include <fstream>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "MemStats.h"
+#include "Node.h"
+#include "Abstract.h"
+#include "SMTpass.h"
+#include "Expr.h"
+#include "utilities.h"
+
+using namespace llvm;
+
+bool MemStats::enabled = false;
+int MemStats::interval = 0;
+TimePoint MemStats::origin;
+std::vector<MemSample> MemStats::samples;
+std::set<Cudd*> MemStats::cudd_managers;
+
+/**
+ * \brief resident memory of PAGAI, in bytes
+ */
+static size_t current_rss() {
+	FILE * f = fopen("/proc/self/statm", "r");
+	if (f == NULL) return 0;
+	unsigned long size, resident;
+	int n = fscanf(f, "%lu %lu", &size, &resident);
+	fclose(f);
+	if (n != 2) return 0;
+	return (size_t)resident * sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * \brief peak resident memory of PAGAI, in bytes
+ */
+static size_t peak_rss() {
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+	// ru_maxrss is in kilobytes on Linux
+	return (size_t)usage.ru_maxrss * 1024;
+}
+
+static void add_apron_size(std::map<params,Abstract*> & X, params P, MemSample & s) {
+	std::map<params,Abstract*>::iterator it = X.find(P);
+	if (it == X.end() || it->second == NULL) return;
+	s.apron_values++;
+	s.apron_size += it->second->apron_size();
+}
+
+void MemStats::start(int i) {
+	origin = time_now();
+	interval = i;
+	enabled = true;
+}
+
+void MemStats::addCudd(Cudd * mgr) {
+	cudd_managers.insert(mgr);
+}
+
+void MemStats::removeCudd(Cudd * mgr) {
+	cudd_managers.erase(mgr);
+}
+
+void MemStats::sample(const char * point, Function * F, params P, SMTpass * LSMT, int iteration) {
+	MemSample s;
+	s.point = point;
+	s.F = F;
+	s.P = P;
+	s.iteration = iteration;
+	s.time = time_now() - origin;
+	s.rss = current_rss();
+	s.peak_rss = peak_rss();
+
+	s.apron_values = 0;
+	s.apron_size = 0;
+	for (Function::iterator it = F->begin(); it != F->end(); ++it) {
+		BasicBlock * b = it;
+		std::map<BasicBlock*,Node*>::iterator n = Nodes.find(b);
+		if (n == Nodes.end()) continue;
+		add_apron_size(n->second->X_s, P, s);
+		add_apron_size(n->second->X_d, P, s);
+		add_apron_size(n->second->X_i, P, s);
+		add_apron_size(n->second->X_f, P, s);
+	}
+
+	s.cudd_managers = cudd_managers.size();
+	s.cudd_nodes = 0;
+	s.cudd_bytes = 0;
+	for (Cudd * mgr : cudd_managers) {
+		s.cudd_nodes += Cudd_ReadNodeCount(mgr->getManager());
+		s.cudd_bytes += Cudd_ReadMemoryInUse(mgr->getManager());
+	}
+
+	s.smt_bytes = (LSMT != NULL) ? LSMT->man->memory_usage() : 0;
+	s.exprs = Expr::num_exprs();
+	samples.push_back(s);
+}
+
+void MemStats::endFunction(Function * F, params P, SMTpass * LSMT) {
+	if (!enabled) return;
+	sample("function", F, P, LSMT, asc_iterations[P][F]);
+	const MemSample & s = samples.back();
+	*Dbg << "// memory " << F->getName()
+		<< " (" << TechniquesToString(P.T) << ", " << ApronManagerToString(P.D) << "):"
+		<< " rss " << s.rss / 1024 << " kB"
+		<< ", peak " << s.peak_rss / 1024 << " kB"
+		<< ", apron " << s.apron_values << " values of size " << s.apron_size
+		<< ", cudd " << s.cudd_managers << " managers, " << s.cudd_nodes << " nodes, "
+		<< s.cudd_bytes / 1024 << " kB"
+		<< ", smt " << s.smt_bytes / 1024 << " kB"
+		<< ", " << s.exprs << " exprs\n";
+}
+
+void MemStats::iteration(Function * F, params P, SMTpass * LSMT) {
+	if (!enabled || interval <= 0) return;
+	int i = asc_iterations[P][F];
+	if (i % interval == 0)
+		sample("iteration", F, P, LSMT, i);
+}
+
+bool MemStats::write(const std::string & filename) {
+	std::ofstream out(filename.c_str());
+	if (!out.is_open()) {
+		*Out << "ERROR: cannot open the memory statistics file " << filename << "\n";
+		return false;
+	}
+	out << "{\"samples\":[\n";
+	for (unsigned i = 0; i < samples.size(); i++) {
+		const MemSample & s = samples[i];
+		if (i > 0) out << ",\n";
+		out << "{\"point\":\"" << s.point << "\""
+			<< ",\"function\":\"" << utilities::json_escape(s.F->getName()) << "\""
+			<< ",\"technique\":\"" << TechniquesToString(s.P.T) << "\""
+			<< ",\"domain\":\"" << ApronManagerToString(s.P.D) << "\""
+			<< ",\"iteration\":" << s.iteration
+			<< ",\"time\":" << s.time.count()
+			<< ",\"rss\":" << s.rss
+			<< ",\"peak_rss\":" << s.peak_rss
+			<< ",\"apron_values\":" << s.apron_values
+			<< ",\"apron_size\":" << s.apron_size
+			<< ",\"cudd_managers\":" << s.cudd_managers
+			<< ",\"cudd_nodes\":" << s.cudd_nodes
+			<< ",\"cudd_bytes\":" << s.cudd_bytes
+			<< ",\"smt_bytes\":" << s.smt_bytes
+			<< ",\"exprs\":" << s.exprs
+			<< "}";
+	}
+	out << "\n]}\n";
+	return true;
+}
@@ -0,0 +1,106 @@
+/**
+ * \file MemStats.h
+ * \brief Declaration of the MemStats class
+ * \author agent
+ */
+#ifndef _MEMSTATS_H
+#define _MEMSTATS_H
+
+#include <cstddef>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "begin_3rdparty.h"
+#include "llvm/IR/Function.h"
+#include "llvm/Support/raw_ostream.h"
+#include "cuddObj.hh"
+#include "end_3rdparty.h"
+
+#include "Analyzer.h"
+#include "Debug.h"
+
+class SMTpass;
+
+/**
+ * \brief memory used when the sample was taken
+ */
+struct MemSample {
+	// "function" at the end of the analysis of F, "iteration" during it
+	const char * point;
+	llvm::Function * F;
+	params P;
+	int iteration;
+	Duration time;
+	// resident memory and peak resident memory of PAGAI, in bytes
+	size_t rss;
+	size_t peak_rss;
+	// abstract values attached to the Nodes of F, and their total size
+	// as measured by Apron
+	size_t apron_values;
+	size_t apron_size;
+	// live CUDD managers (path trees and Sigma), their nodes and bytes
+	size_t cudd_managers;
+	size_t cudd_nodes;
+	size_t cudd_bytes;
+	// memory of the SMT solver, 0 if the backend cannot tell
+	size_t smt_bytes;
+	// expressions cached by Expr
+	size_t exprs;
+};
+
+/**
+ * \class MemStats
+ * \brief memory telemetry of the analysis, enabled with --memstats
+ *
+ * A sample is taken at the end of the analysis of each function, and every
+ * --memstats-interval ascending iterations. The sample at the end of a
+ * function is printed on Dbg, all the samples are written in JSON into the
+ * file given to --memstats.
+ */
+class MemStats {
+
+	private:
+		static bool enabled;
+		static int interval;
+		static TimePoint origin;
+		static std::vector<MemSample> samples;
+
+		/**
+		 * \brief CUDD managers currently alive
+		 */
+		static std::set<Cudd*> cudd_managers;
+
+		static void sample(const char * point, llvm::Function * F, params P, SMTpass * LSMT, int iteration);
+
+	public:
+		/**
+		 * \brief starts sampling, every interval iterations if interval > 0
+		 */
+		static void start(int interval);
+
+		static bool isEnabled() {return enabled;}
+
+		static void addCudd(Cudd * mgr);
+		static void removeCudd(Cudd * mgr);
+
+		/**
+		 * \brief sample at the end of the analysis of F
+		 * \param LSMT the SMT pass used by the analysis, may be NULL
+		 */
+		static void endFunction(llvm::Function * F, params P, SMTpass * LSMT);
+
+		/**
+		 * \brief called at each ascending iteration, samples every interval
+		 * iterations
+		 */
+		static void iteration(llvm::Function * F, params P, SMTpass * LSMT);
+
+		/**
+		 * \brief writes all the samples into filename
+		 * \return false if the file cannot be written
+		 */
+		static bool write(const std::string & filename);
+};
+
+#endif
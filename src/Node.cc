@@ -31,6 +31,8 @@ Node::Node(BasicBlock * _bb) {
 	index = 0;
 	lowlink = 0;
 	isInStack = false;
+	sccId = 0;
+	sccRank = 0;
 	bb = _bb;
 	id = i++;
 	env = new Environment();
@@ -65,11 +67,12 @@ void Node::setEnv(Environment * e) {
 void Node::computeSCC() {
 	std::stack<Node*> * S = new std::stack<Node*>();
 	int n = 1;
-	computeSCC_rec(n,S);
+	int c = 0;
+	computeSCC_rec(n,c,S);
 	delete S;
 }
 
-void Node::computeSCC_rec(int & n,std::stack<Node*> * S) {
+void Node::computeSCC_rec(int & n, int & c, std::stack<Node*> * S) {
 	Node * nsucc;
 	index=n;
 	lowlink=n;
@@ -81,7 +84,7 @@ void Node::computeSCC_rec(int & n,std::stack<Node*> * S) {
 		nsucc = Nodes[succ];
 		switch (nsucc->index) {
 			case 0:
-				nsucc->computeSCC_rec(n,S);
+				nsucc->computeSCC_rec(n,c,S);
 				lowlink = std::min(lowlink,nsucc->lowlink);
 				break;
 			default:
@@ -91,11 +94,13 @@ void Node::computeSCC_rec(int & n,std::stack<Node*> * S) {
 		}
 	}
 	if (lowlink == index) {
+		c++;
 		do {
 			nsucc = S->top();
 			S->pop();
 			nsucc->isInStack=false;
 			nsucc->sccId = index;
+			nsucc->sccRank = c;
 		} while (nsucc != this);
 	}
 }
@@ -122,6 +127,10 @@ void Node::add_var(Value * val) {
 }
 
 bool NodeCompare::operator() (Node * n1, Node * n2) {
+	if (topologicalWorklist()) {
+		if (n1->sccRank != n2->sccRank) return n1->sccRank < n2->sccRank;
+		return (n1->id > n2->id);
+	}
 	if (n1->sccId < n2->sccId) return true;
 	return (n1->id > n2->id);
 }
@@ -66,9 +66,10 @@ class Node {
 		/**
 		 * \brief recursive version of the tarjan's algorithm
 		 * compute both the loop heads and the Strongly connected components
-		 * Must be called with n=1 and and empty allocated stack
+		 * Must be called with n=1, c=0 and and empty allocated stack
+		 * \param c number of components already completed
 		 */
-		void computeSCC_rec(int & n,std::stack<Node*> * S);
+		void computeSCC_rec(int & n, int & c, std::stack<Node*> * S);
 
 		/**
 		 * \}
@@ -103,6 +104,14 @@ class Node {
 		 * \brief sccId identifies the strongly connected component the node is in
 		 */
 		int sccId;
+
+		/**
+		 * \brief rank of the strongly connected component in the DAG of
+		 * components. Components are completed from the sinks of the DAG,
+		 * so every edge between two components goes from a greater rank to a
+		 * smaller one, and sibling components never feed each other.
+		 */
+		int sccRank;
 		int id;
 
 		/**
@@ -161,6 +170,11 @@ extern std::map<llvm::BasicBlock *,Node *> Nodes;
  * \brief This class is used to order the Nodes such that they are
  * poped in the right order (following the SCC order) when treated by
  * the AI algorithm.
+ *
+ * With --worklist topological, the nodes of a component are popped before
+ * the nodes of the components it reaches, so each loop nest is stabilized
+ * once its entry values are, and is not iterated again when a sibling loop
+ * nest changes.
  */
 class NodeCompare {
 	public:
@@ -0,0 +1,217 @@
+/**
+ * \file Output.cc
+ * \brief Implementation of the OutputSink class
+ * \author agent
+ */
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#include <unistd.h>
+
+#include "begin_3rdparty.h"
+#include "llvm/Support/Process.h"
+#include "end_3rdparty.h"
+
+#include "Output.h"
+
+using namespace llvm;
+
+/**
+ * \brief buffer of a thread
+ *
+ * The signal handler may read the buffer of the thread it interrupts, so
+ * data and size are atomic, and the first size bytes of data are valid at
+ * any time: a new array is published before the old one is freed.
+ */
+struct OutputBuffer {
+	std::atomic<char*> data;
+	std::atomic<size_t> size;
+	size_t capacity;
+};
+
+#define MAX_OUTPUT_THREADS 64
+
+/**
+ * \brief buffers of the threads, read by the signal handler; a thread
+ * beyond MAX_OUTPUT_THREADS still has a buffer, that is not written on a
+ * crash
+ */
+static std::atomic<OutputBuffer*> buffers[MAX_OUTPUT_THREADS];
+static std::atomic<unsigned> nbuffers(0);
+
+// serializes the blocks written by the different threads
+static std::mutex write_mutex;
+
+// file descriptor of the sink, for the signal handler
+static std::atomic<int> sink_fd(-1);
+
+static const int crash_signals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT, SIGINT, SIGTERM};
+#define NUM_CRASH_SIGNALS (sizeof(crash_signals) / sizeof(crash_signals[0]))
+static struct sigaction previous_actions[NUM_CRASH_SIGNALS];
+
+static OutputBuffer * threadBuffer() {
+	static thread_local OutputBuffer * b = NULL;
+	if (b == NULL) {
+		b = new OutputBuffer();
+		b->capacity = 1 << 16;
+		b->data = new char[b->capacity];
+		b->size = 0;
+		unsigned id = nbuffers++;
+		if (id < MAX_OUTPUT_THREADS) buffers[id] = b;
+	}
+	return b;
+}
+
+/**
+ * \brief writes the size bytes of data, only uses async-signal-safe calls
+ */
+static void writeAll(int fd, const char * data, size_t size) {
+	while (size > 0) {
+		ssize_t n = write(fd, data, size);
+		if (n < 0) {
+			if (errno == EINTR) continue;
+			return;
+		}
+		data += n;
+		size -= n;
+	}
+}
+
+static void writeBuffersOnSignal(int sig) {
+	int fd = sink_fd;
+	if (fd >= 0) {
+		unsigned n = nbuffers;
+		if (n > MAX_OUTPUT_THREADS) n = MAX_OUTPUT_THREADS;
+		for (unsigned i = 0; i < n; i++) {
+			OutputBuffer * b = buffers[i];
+			if (b == NULL) continue;
+			writeAll(fd, b->data, b->size);
+			b->size = 0;
+		}
+	}
+	// the signal is delivered again to the previous handler when this one
+	// returns
+	for (unsigned i = 0; i < NUM_CRASH_SIGNALS; i++) {
+		if (crash_signals[i] == sig)
+			sigaction(sig, &previous_actions[i], NULL);
+	}
+	raise(sig);
+}
+
+OutputSink * OutputSink::instance = NULL;
+
+static void commitOnExit() {
+	OutputSink::commitOutput();
+}
+
+OutputSink::OutputSink(int fd) : raw_ostream(true), fd(fd) {
+	displayed = sys::Process::FileDescriptorIsDisplayed(fd);
+	instance = this;
+	sink_fd = fd;
+
+	// PAGAI may exit in the middle of the analysis of a function
+	static bool exit_handler = false;
+	if (!exit_handler) {
+		std::atexit(commitOnExit);
+		exit_handler = true;
+	}
+
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = writeBuffersOnSignal;
+	sigemptyset(&action.sa_mask);
+	for (unsigned i = 0; i < NUM_CRASH_SIGNALS; i++) {
+		sigaction(crash_signals[i], &action, &previous_actions[i]);
+		// keep ignoring the signals that were ignored
+		if (previous_actions[i].sa_handler == SIG_IGN)
+			sigaction(crash_signals[i], &previous_actions[i], NULL);
+	}
+}
+
+OutputSink::~OutputSink() {
+	commitAll();
+	for (unsigned i = 0; i < NUM_CRASH_SIGNALS; i++) {
+		sigaction(crash_signals[i], &previous_actions[i], NULL);
+	}
+	sink_fd = -1;
+	instance = NULL;
+}
+
+void OutputSink::write_impl(const char * ptr, size_t size) {
+	OutputBuffer * b = threadBuffer();
+	size_t used = b->size;
+	if (used + size > b->capacity) {
+		size_t capacity = 2 * b->capacity;
+		if (capacity < used + size) capacity = used + size;
+		char * old = b->data;
+		char * data = new char[capacity];
+		memcpy(data, old, used);
+		b->data = data;
+		b->capacity = capacity;
+		delete [] old;
+	}
+	char * data = b->data;
+	memcpy(data + used, ptr, size);
+	b->size = used + size;
+}
+
+uint64_t OutputSink::current_pos() const {
+	return threadBuffer()->size;
+}
+
+void OutputSink::commit() {
+	OutputBuffer * b = threadBuffer();
+	if (b->size == 0) return;
+	{
+		std::lock_guard<std::mutex> lock(write_mutex);
+		writeAll(fd, b->data, b->size);
+	}
+	b->size = 0;
+}
+
+void OutputSink::commitAll() {
+	std::lock_guard<std::mutex> lock(write_mutex);
+	unsigned n = nbuffers;
+	if (n > MAX_OUTPUT_THREADS) n = MAX_OUTPUT_THREADS;
+	for (unsigned i = 0; i < n; i++) {
+		OutputBuffer * b = buffers[i];
+		if (b == NULL) continue;
+		writeAll(fd, b->data, b->size);
+		b->size = 0;
+	}
+}
+
+void OutputSink::commitOutput() {
+	if (instance != NULL) instance->commit();
+}
+
+bool OutputSink::is_displayed() const {
+	return displayed;
+}
+
+raw_ostream & OutputSink::changeColor(enum Colors colors, bool bold, bool bg) {
+	if (!displayed) return *this;
+	const char * colorcode = (colors == SAVEDCOLOR) ?
+		sys::Process::OutputBold(bg) :
+		sys::Process::OutputColor(colors, bold, bg);
+	if (colorcode) write(colorcode, strlen(colorcode));
+	return *this;
+}
+
+raw_ostream & OutputSink::resetColor() {
+	if (!displayed) return *this;
+	const char * colorcode = sys::Process::ResetColor();
+	if (colorcode) write(colorcode, strlen(colorcode));
+	return *this;
+}
+
+raw_ostream & OutputSink::reverseColor() {
+	if (!displayed) return *this;
+	const char * colorcode = sys::Process::OutputReverse();
+	if (colorcode) write(colorcode, strlen(colorcode));
+	return *this;
+}
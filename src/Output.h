@@ -0,0 +1,73 @@
+/**
+ * \file Output.h
+ * \brief Declaration of the OutputSink class
+ * \author agent
+ */
+#ifndef _OUTPUT_H
+#define _OUTPUT_H
+
+#include <cstdint>
+
+#include "begin_3rdparty.h"
+#include "llvm/Support/raw_ostream.h"
+#include "end_3rdparty.h"
+
+/**
+ * \class OutputSink
+ * \brief stream writing to a file descriptor, through a buffer per thread
+ *
+ * What a thread writes stays in its own buffer, without any lock or system
+ * call, until it calls commit(). The buffer is then written in one block,
+ * so that the output of a function is never mixed with the output of
+ * another thread. The analysis passes commit after the result of each
+ * function.
+ *
+ * If PAGAI is killed by a signal, the buffers that are not committed yet are
+ * written by the signal handler, so that the output of the function being
+ * analyzed is not lost.
+ *
+ * There is at most one OutputSink at a time.
+ */
+class OutputSink : public llvm::raw_ostream {
+
+	private:
+		static OutputSink * instance;
+
+		int fd;
+		bool displayed;
+
+		void write_impl(const char * ptr, size_t size);
+		uint64_t current_pos() const;
+
+	public:
+		OutputSink(int fd);
+
+		/**
+		 * \brief commits the buffers of all the threads
+		 */
+		~OutputSink();
+
+		/**
+		 * \brief writes the buffer of the calling thread
+		 */
+		void commit();
+
+		/**
+		 * \brief writes the buffers of all the threads, when no other thread
+		 * writes anymore
+		 */
+		void commitAll();
+
+		/**
+		 * \brief commits the buffer of the calling thread, if the output
+		 * goes to an OutputSink
+		 */
+		static void commitOutput();
+
+		bool is_displayed() const;
+		llvm::raw_ostream & changeColor(enum Colors colors, bool bold = false, bool bg = false);
+		llvm::raw_ostream & resetColor();
+		llvm::raw_ostream & reverseColor();
+};
+
+#endif
@@ -13,6 +13,7 @@
 #include "PathTree_br.h"
 #include "Analyzer.h"
 #include "Pr.h"
+#include "MemStats.h"
 
 using namespace llvm;
 
@@ -46,6 +47,7 @@ BranchInst * PathTree_br::getConditionnalBranch(BasicBlock * b, bool start) {
 
 PathTree_br::PathTree_br(BasicBlock * Start) {
 	mgr = new Cudd(0,0);
+	MemStats::addCudd(mgr);
 	//mgr->makeVerbose();
 	Bdd = new BDD(mgr->bddZero());
 	Bdd_prime = new BDD(mgr->bddZero());
@@ -62,6 +64,7 @@ PathTree_br::PathTree_br(BasicBlock * Start) {
 PathTree_br::~PathTree_br() {
 	delete Bdd;
 	delete Bdd_prime;
+	MemStats::removeCudd(mgr);
 	delete mgr;
 }
 
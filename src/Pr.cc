@@ -3,6 +3,8 @@
  * \brief Implementation of the Pr class
  * \author Julien Henry
  */
+#include <algorithm>
+
 #include "begin_3rdparty.h"
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Transforms/Scalar.h"
@@ -14,12 +16,15 @@
 #include "Analyzer.h"
 #include "Debug.h"
 #include "IdentifyLoops.h"
+#include "ExtractChecks.h"
 
 using namespace llvm;
 
 std::map<Function *, Pr *> PR_instances;
 
 Pr::Pr(Function * _F) : F(_F) {
+	CFG_graph.initCFG(F);
+	Pr_graph.init(F);
 	if (!F->isDeclaration())
 		computePr();
 }
@@ -57,6 +62,10 @@ std::set<BasicBlock*> & Pr::getUndefinedBehaviour() {
 	return UndefBehaviour_set;
 }
 
+std::vector<CallInst*> & Pr::getChecks() {
+	return Check_list;
+}
+
 bool Pr::inPr(BasicBlock * b) {
 	return Pr_set.count(b);
 }
@@ -196,6 +205,15 @@ void Pr::computePr() {
 	computeLoopHeaders(Pr_set);
 
 	//minimize_Pr(F);
+	if (minimizeCutPoints()) {
+		DEBUG(
+			*Dbg << "Pw: " << Pr_set.size() << " loop headers\n";
+		);
+		minimize_Pw(Pr_set);
+		DEBUG(
+			*Dbg << "Pw: " << Pr_set.size() << " after minimization\n";
+		);
+	}
 
 	//if (!check_acyclic(&Pr_set)) {
 	//	*Out << "ERROR : GRAPH IS NOT ACYCLIC !\n";
@@ -217,6 +235,11 @@ void Pr::computePr() {
 			if (isa<ReturnInst>(*it) || isa<UnreachableInst>(*it)) {
 				Pr_set.insert(b);
 			} else if (CallInst * c = dyn_cast<CallInst>((Instruction*)it)) {
+				if (ExtractChecks::isCheck(c)) {
+					// checked after the analysis, without splitting paths
+					Check_list.push_back(c);
+					continue;
+				}
 				Function * cF = c->getCalledFunction();
 				std::string fname;
 				if (cF == NULL) {
@@ -274,11 +297,68 @@ void Pr::minimize_Pr() {
 	}
 }
 
-std::set<BasicBlock*> Pr::getPrPredecessors(BasicBlock * b) {
-	return Pr_pred[b];
+bool Pr::onUncutCycle(
+		unsigned h,
+		const std::vector<bool> & cut,
+		std::vector<unsigned> & seen,
+		unsigned stamp) const {
+	std::vector<unsigned> stack(1, h);
+	while (!stack.empty()) {
+		unsigned b = stack.back();
+		stack.pop_back();
+		for (BasicBlock * succ : CFG_graph.successors(CFG_graph.getBlock(b))) {
+			unsigned s = CFG_graph.getId(succ);
+			if (s == h) return true;
+			if (cut[s] || seen[s] == stamp) continue;
+			seen[s] = stamp;
+			stack.push_back(s);
+		}
+	}
+	return false;
+}
+
+void Pr::minimize_Pw(std::set<BasicBlock*> & W) {
+	std::vector<bool> cut(CFG_graph.size(), false);
+	// (number of predecessors * number of successors, id)
+	std::vector<std::pair<size_t,unsigned> > candidates;
+	for (BasicBlock * b : W) {
+		unsigned id = CFG_graph.getId(b);
+		cut[id] = true;
+		candidates.push_back(std::make_pair(
+					CFG_graph.predecessors(b).size() * CFG_graph.successors(b).size(),
+					id));
+	}
+	std::sort(candidates.begin(), candidates.end());
+
+	// W minus the candidate already cuts all the cycles that do not go
+	// through the candidate, so the candidate is needed iff it is on a cycle
+	// with no other block of W
+	std::vector<unsigned> seen(CFG_graph.size(), 0);
+	unsigned stamp = 0;
+	for (auto & c : candidates) {
+		unsigned h = c.second;
+		cut[h] = false;
+		if (onUncutCycle(h, cut, seen, ++stamp)) {
+			cut[h] = true;
+		} else {
+			W.erase(CFG_graph.getBlock(h));
+		}
+	}
+}
+
+BlockRange Pr::getPrPredecessors(BasicBlock * b) const {
+	return Pr_graph.predecessors(b);
+}
+
+BlockRange Pr::getPrSuccessors(BasicBlock * b) const {
+	return Pr_graph.successors(b);
+}
+
+BlockRange Pr::getCFGPredecessors(BasicBlock * b) const {
+	return CFG_graph.predecessors(b);
 }
 
-std::set<BasicBlock*> Pr::getPrSuccessors(BasicBlock * b) {
-	return Pr_succ[b];
+BlockRange Pr::getCFGSuccessors(BasicBlock * b) const {
+	return CFG_graph.successors(b);
 }
 
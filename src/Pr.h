@@ -8,12 +8,14 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 #include "begin_3rdparty.h"
 #include "llvm/Analysis/CFG.h"
 #include "end_3rdparty.h"
 
 #include "Node.h"
+#include "BlockGraph.h"
 
 /**
  * \class Pr
@@ -37,6 +39,16 @@ class Pr {
 		std::set<llvm::BasicBlock*> Assert_set;
 		std::set<llvm::BasicBlock*> UndefBehaviour_set;
 
+		/**
+		 * \brief calls to __pagai_check, in the order of the function
+		 */
+		std::vector<llvm::CallInst*> Check_list;
+
+		/**
+		 * \brief control flow graph of the function
+		 */
+		BlockGraph CFG_graph;
+
 		std::map<Node*,int> index;
 		std::map<Node*,int> lowlink;
 		std::map<Node*,bool> isInStack;
@@ -62,6 +74,26 @@ class Pr {
 
 		void minimize_Pr();
 
+		/**
+		 * \brief removes from W the blocks that are not needed to cut all
+		 * the cycles of the function
+		 *
+		 * greedy feedback vertex set heuristic: the blocks with the fewest
+		 * incoming and outgoing edges are removed first, as long as every
+		 * cycle keeps a block of W.
+		 */
+		void minimize_Pw(std::set<llvm::BasicBlock*> & W);
+
+		/**
+		 * \brief true iff a cycle goes through the block of id h and
+		 * through no other cut block
+		 */
+		bool onUncutCycle(
+				unsigned h,
+				const std::vector<bool> & cut,
+				std::vector<unsigned> & seen,
+				unsigned stamp) const;
+
 		/**
 		 * \brief private constructor
 		 */
@@ -77,17 +109,13 @@ class Pr {
 		~Pr();
 
 		/**
-		 * \brief associate to each basicBlock its successors in Pr
+		 * \brief graph between the blocks of Pr: there is an edge from a to
+		 * b iff there is a path from a to b whose intermediate blocks are
+		 * not in Pr
 		 *
-		 * WARNING : this set is filled by SMTpass
+		 * WARNING : this graph is filled by SMTpass
 		 */
-		std::map<llvm::BasicBlock*, std::set<llvm::BasicBlock*> > Pr_succ;
-		/**
-		 * \brief associate to each basicBlock its predecessors in Pr
-		 *
-		 * WARNING : this set is filled by SMTpass
-		 */
-		std::map<llvm::BasicBlock*, std::set<llvm::BasicBlock*> > Pr_pred;
+		BlockGraph Pr_graph;
 
 		/**
 		 * \brief get the set Pr. The set Pr is computed only once
@@ -102,22 +130,36 @@ class Pr {
 		std::set<llvm::BasicBlock*> & getAssert();
 		std::set<llvm::BasicBlock*> & getUndefinedBehaviour();
 
+		/**
+		 * \brief undefined behaviour checks that are not blocks of Pr,
+		 * see ExtractChecks
+		 */
+		std::vector<llvm::CallInst*> & getChecks();
+
 		bool inPr(llvm::BasicBlock * b);
 		bool inPw(llvm::BasicBlock * b);
 		bool inAssert(llvm::BasicBlock * b);
 		bool inUndefBehaviour(llvm::BasicBlock * b);
 
 		/**
-		 * \brief returns a set containing all the predecessors of
-		 * b in Pr
+		 * \brief returns the predecessors of b in Pr
+		 */
+		BlockRange getPrPredecessors(llvm::BasicBlock * b) const;
+
+		/**
+		 * \brief returns the successors of b in Pr
+		 */
+		BlockRange getPrSuccessors(llvm::BasicBlock * b) const;
+
+		/**
+		 * \brief returns the predecessors of b in the control flow graph
 		 */
-		std::set<llvm::BasicBlock*> getPrPredecessors(llvm::BasicBlock * b);
+		BlockRange getCFGPredecessors(llvm::BasicBlock * b) const;
 
 		/**
-		 * \brief returns a set containing all the successors of
-		 * b in Pr
+		 * \brief returns the successors of b in the control flow graph
 		 */
-		std::set<llvm::BasicBlock*> getPrSuccessors(llvm::BasicBlock * b);
+		BlockRange getCFGSuccessors(llvm::BasicBlock * b) const;
 };
 
 extern std::map<llvm::Function *, Pr *> PR_instances;
@@ -3,12 +3,38 @@
  * \brief Implementation of the SMT_manager class
  * \author Julien Henry
  */
+#include <climits>
+
 #include "SMT_manager.h"
 
+SMT_expr SMT_manager::SMT_mk_num_int64(int64_t n) {
+  if (n >= INT_MIN && n <= INT_MAX) return SMT_mk_num((int)n);
+  mpq_t mpq;
+  mpq_init(mpq);
+  mpz_set_si(mpq_numref(mpq), (long)n);
+  SMT_expr res = SMT_mk_num_mpq(mpq);
+  mpq_clear(mpq);
+  return res;
+}
+
 SMT_expr SMT_manager::SMT_mk_divides(SMT_expr a1, SMT_expr a2) {
   return SMT_mk_eq(SMT_mk_rem(a2, a1), SMT_mk_num(0));
 }
 
+std::string SMT_manager::SMT_to_smtlib2(SMT_expr a) {
+  (void) a;
+  return "";
+}
+
 bool SMT_manager::interrupt() {
   return false;
 }
+
+bool SMT_manager::set_timeout(unsigned ms) {
+  (void) ms;
+  return false;
+}
+
+size_t SMT_manager::memory_usage() {
+  return 0;
+}
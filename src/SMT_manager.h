@@ -6,6 +6,7 @@
 #ifndef SMT_MANAGER_H
 #define SMT_MANAGER_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <set>
@@ -198,7 +199,16 @@ class SMT_manager {
 		SMT_type int_type;
 		SMT_type float_type;
 		SMT_type bool_type;
+
+		/**
+		 * \brief bytes exchanged with the solver and time spent parsing
+		 * its replies during the last SMT_check, for the solvers run
+		 * through a pipe
+		 */
+		size_t query_bytes;
+		Duration query_parse_time;
 	public:
+		SMT_manager() : query_bytes(0), query_parse_time(Duration::zero()) {}
 		virtual ~SMT_manager() {}
 
 		virtual SMT_expr SMT_mk_true() = 0;
@@ -217,6 +227,11 @@ class SMT_manager {
 
 		virtual SMT_expr SMT_mk_num (int n) = 0;
 		virtual SMT_expr SMT_mk_num_mpq (mpq_t mpq) = 0;
+		/**
+		 * \brief integer numeral, without going through a string or an
+		 * mpq for the solvers that have a native 64-bit API
+		 */
+		virtual SMT_expr SMT_mk_num_int64 (int64_t n);
 		virtual SMT_expr SMT_mk_real (double x) = 0;
 
 		virtual SMT_expr SMT_mk_sum (std::vector<SMT_expr> args) = 0;
@@ -253,7 +268,26 @@ class SMT_manager {
 		virtual void SMT_assert(SMT_expr a) = 0;
 		virtual int SMT_check(SMT_expr a, std::set<std::string> & true_booleans) = 0;
 
+		/**
+		 * \brief SMT-LIB2 script declaring the variables of a and asserting
+		 * it, without check-sat. Empty if the backend cannot print formulae.
+		 */
+		virtual std::string SMT_to_smtlib2(SMT_expr a);
+
 		virtual bool interrupt();
+
+		/**
+		 * \brief limits the time of the next checks to ms milliseconds, 0
+		 * meaning the limit given by --timeout, or no limit
+		 * \return false if the backend cannot limit the time of a check
+		 */
+		virtual bool set_timeout(unsigned ms);
+
+		/**
+		 * \brief memory used by the solver, in bytes, 0 if the backend
+		 * cannot tell
+		 */
+		virtual size_t memory_usage();
 };
 
 #endif
@@ -0,0 +1,106 @@
+/**
+ * \file SMTcapture.cc
+ * \brief Implementation of the SMTcapture class
+ * \author agent
+ */
+#include <fstream>
+
+#include "SMTcapture.h"
+#include "SMTcaptureFormat.h"
+#include "Analyzer.h"
+
+static std::ofstream * capture_file = NULL;
+static int capture_counter = 0;
+static int context_counter = 0;
+static unsigned long assertion_counter = 0;
+
+static std::ofstream & getCaptureFile() {
+	if (capture_file == NULL) {
+		capture_file = new std::ofstream(getSMTCaptureFilename().c_str());
+		if (!capture_file->is_open())
+			*Dbg << "ERROR: cannot open " << getSMTCaptureFilename() << "\n";
+		*capture_file << SMT_CAPTURE_HEADER << "\n";
+	}
+	return *capture_file;
+}
+
+SMTcapture::SMTcapture() : context(-1) {
+	clear();
+}
+
+bool SMTcapture::enabled() {
+	return capture_smt();
+}
+
+void SMTcapture::push_context() {
+	stack.push_back(std::vector<Assertion>());
+}
+
+void SMTcapture::pop_context() {
+	stack.pop_back();
+	if (stack.empty()) clear();
+}
+
+void SMTcapture::SMT_assert(SMT_expr expr) {
+	Assertion a;
+	a.expr = expr;
+	a.id = assertion_counter++;
+	stack.back().push_back(a);
+}
+
+void SMTcapture::clear() {
+	stack.clear();
+	stack.push_back(std::vector<Assertion>());
+}
+
+void SMTcapture::SMT_check(SMT_manager * man, SMT_expr expr, int result, Duration time) {
+	std::vector<SMT_expr> cunj;
+	std::vector<unsigned long> ids;
+	for (auto & level : stack) {
+		for (const Assertion & a : level) {
+			cunj.push_back(a.expr);
+			ids.push_back(a.id);
+		}
+	}
+	size_t assertions = cunj.size();
+
+	std::ofstream & out = getCaptureFile();
+	// the script is empty when the backend cannot print its formulae
+	// (yices_api): the record then has no script and no context
+	std::string script = man->SMT_to_smtlib2(expr);
+	bool in_context = !cunj.empty() && !script.empty();
+
+	// the stack, with rho, is only written when it changed since the last
+	// query
+	if (in_context && (context < 0 || ids != context_ids)) {
+		context = context_counter++;
+		context_ids = ids;
+		out << SMT_CAPTURE_CONTEXT << context << "\n";
+		out << man->SMT_to_smtlib2(man->SMT_mk_and(cunj));
+		out << SMT_CAPTURE_END << "\n";
+	}
+
+	out << SMT_CAPTURE_QUERY << capture_counter++ << "\n";
+	if (in_context)
+		out << SMT_CAPTURE_IN_CONTEXT << context << "\n";
+	out << SMT_CAPTURE_BACKEND << getSMTSolverName() << "\n";
+	out << SMT_CAPTURE_RESULT;
+	switch (result) {
+		case 1: out << "sat\n"; break;
+		case 0: out << "unsat\n"; break;
+		default: out << "unknown\n";
+	}
+	out << SMT_CAPTURE_TIME << time.count() << "\n";
+	out << SMT_CAPTURE_ASSERTIONS << assertions << "\n";
+	out << SMT_CAPTURE_PIPE_BYTES << man->query_bytes << "\n";
+	out << SMT_CAPTURE_PARSE_TIME << man->query_parse_time.count() << "\n";
+	if (!script.empty()) {
+		out << script;
+		out << "(check-sat)\n";
+	}
+	out << SMT_CAPTURE_END << "\n";
+	out.flush();
+
+	// the SMT_check of the managers leaves the query asserted
+	SMT_assert(expr);
+}
@@ -0,0 +1,75 @@
+/**
+ * \file SMTcapture.h
+ * \brief Declaration of the SMTcapture class
+ * \author agent
+ */
+#ifndef SMTCAPTURE_H
+#define SMTCAPTURE_H
+
+#include <vector>
+
+#include "SMT_manager.h"
+#include "Debug.h"
+
+/**
+ * \class SMTcapture
+ * \brief records the queries of an SMTpass into the file given by
+ * --smt-capture
+ *
+ * The class mirrors the assertion stack of the solver, so that each query is
+ * written with all the formulae it is checked against (see
+ * SMTcaptureFormat.h). The stack is written once for all the queries checked
+ * against it, so that rho is not written again with each query.
+ * All the SMTpass instances write in the same file.
+ */
+class SMTcapture {
+
+	private:
+		/**
+		 * \brief a formula of the stack, with a number that identifies its
+		 * assertion
+		 */
+		struct Assertion {
+			SMT_expr expr;
+			unsigned long id;
+		};
+
+		/**
+		 * \brief formulae asserted at each level of the stack
+		 */
+		std::vector<std::vector<Assertion> > stack;
+
+		/**
+		 * \brief assertions of the last context record written for this
+		 * stack, and the number of this record
+		 */
+		std::vector<unsigned long> context_ids;
+		int context;
+
+	public:
+		SMTcapture();
+
+		/**
+		 * \brief true iff --smt-capture is given
+		 */
+		static bool enabled();
+
+		void push_context();
+		void pop_context();
+		void SMT_assert(SMT_expr expr);
+
+		/**
+		 * \brief empties the assertion stack, when the solver is reset
+		 */
+		void clear();
+
+		/**
+		 * \brief writes the record of a query
+		 * \param man the manager that solved the query
+		 * \param expr the query, which stays asserted in the solver
+		 * \param result 1 if sat, 0 if unsat, -1 if unknown
+		 * \param time solving time
+		 */
+		void SMT_check(SMT_manager * man, SMT_expr expr, int result, Duration time);
+};
+#endif
@@ -0,0 +1,55 @@
+/**
+ * \file SMTcaptureFormat.h
+ * \brief Markers of the SMT capture files written by --smt-capture
+ * \author agent
+ *
+ * A capture file is a sequence of records. A context record holds the
+ * assertion stack of the solver (rho, the invariants...), and is written
+ * each time a query is checked against a stack that was not written yet:
+ *
+ * \code
+ * ; @context <number>
+ * <declarations and asserts, SMT-LIB2>
+ * ; @end
+ * \endcode
+ *
+ * Then each SMT_check gives a query record:
+ *
+ * \code
+ * ; @query <number>
+ * ; @in-context <number of the context record, absent if the stack is empty>
+ * ; @backend <solver given to pagai with -s>
+ * ; @result sat|unsat|unknown
+ * ; @time <solving time in seconds>
+ * ; @assertions <number of formulae asserted before the query>
+ * ; @pipe-bytes <bytes exchanged with a pipe solver, 0 for the APIs>
+ * ; @parse-time <time spent parsing the replies of a pipe solver>
+ * <declarations and asserts, SMT-LIB2>
+ * (check-sat)
+ * ; @end
+ * \endcode
+ *
+ * The query is checked by appending its script to the one of its context.
+ * The declarations of the query script that already are in the context
+ * script must then be skipped.
+ * When the backend cannot print its formulae (yices_api), the query records
+ * have no script and no context: they only give the result and the timings,
+ * and are skipped by the replay.
+ * Records are read by pagai-smt-replay (src/tools/smt_replay.cc).
+ */
+#ifndef SMTCAPTUREFORMAT_H
+#define SMTCAPTUREFORMAT_H
+
+#define SMT_CAPTURE_HEADER "; pagai smt capture 2"
+#define SMT_CAPTURE_CONTEXT "; @context "
+#define SMT_CAPTURE_QUERY "; @query "
+#define SMT_CAPTURE_IN_CONTEXT "; @in-context "
+#define SMT_CAPTURE_BACKEND "; @backend "
+#define SMT_CAPTURE_RESULT "; @result "
+#define SMT_CAPTURE_TIME "; @time "
+#define SMT_CAPTURE_ASSERTIONS "; @assertions "
+#define SMT_CAPTURE_PIPE_BYTES "; @pipe-bytes "
+#define SMT_CAPTURE_PARSE_TIME "; @parse-time "
+#define SMT_CAPTURE_END "; @end"
+
+#endif
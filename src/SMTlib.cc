@@ -11,6 +11,9 @@
 #include <fstream>
 #include <csignal>
 #include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <gmp.h>
 
 #include <sys/wait.h>
@@ -23,7 +26,6 @@
 #include "SMTlib.h"
 #include "Analyzer.h"
 #include "Debug.h"
-#include "SMTlib2driver.h"
 
 SMTlib::SMTlib() {
 	stack_level = 0;
@@ -73,7 +75,7 @@ void SMTlib::SMTlib_init() {
 				mathsat_argv[1] = NULL;
 				if (execvp("mathsat",mathsat_argv)) {
 					perror("exec mathsat");
-					exit(1);
+					_exit(1);
 				}
 				break;
 			case SMTINTERPOL:
@@ -82,7 +84,7 @@ void SMTlib::SMTlib_init() {
 				smtinterpol_argv[1] = NULL;
 				if (execvp("smtinterpol",smtinterpol_argv)) {
 					perror("exec smtinterpol");
-					exit(1);
+					_exit(1);
 				}
 				break;
 			case Z3:
@@ -94,7 +96,7 @@ void SMTlib::SMTlib_init() {
 				z3_argv[3] = NULL;
 				if (execvp("z3",z3_argv)) {
 					perror("exec z3");
-					exit(1);
+					_exit(1);
 				}
 				break;
 			case CVC3:
@@ -105,7 +107,7 @@ void SMTlib::SMTlib_init() {
 				cvc3_argv[3] = NULL;
 				if (execvp("cvc3",cvc3_argv)) {
 					perror("exec cvc3");
-					exit(1);
+					_exit(1);
 				}
 				break;
 			case CVC4:
@@ -121,11 +123,11 @@ void SMTlib::SMTlib_init() {
 				cvc4_argv[8] = NULL;
 				if (execvp("cvc4",cvc4_argv)) {
 					perror("exec cvc4");
-					exit(1);
+					_exit(1);
 				}
 				break;
 			default:
-				exit(1);
+				_exit(1);
 		}
 	}
 
@@ -133,12 +135,8 @@ void SMTlib::SMTlib_init() {
 	solver_pid = cpid;
 	close(wpipefd[0]);
 	close(rpipefd[1]);
-	input = fdopen(rpipefd[0],"r");
-	//setbuf(input, NULL);
-	if (input == NULL) {
-		perror("fdopen");
-		exit(1);
-	}
+	reader = new SMTlib2reader(rpipefd[0]);
+	get_value_outdated = true;
 
 	//Enable model construction
 	if (getSMTSolver() == CVC3 || getSMTSolver() == CVC4) {
@@ -149,9 +147,11 @@ void SMTlib::SMTlib_init() {
 		if (getSMTSolver() == Z3 || getSMTSolver() == Z3_QFNRA) {
 			pwrite("(set-option :interactive-mode true)\n");
 			pwrite("(set-option :global-decls false)\n");
+			soft_timeout = UINT_MAX;
 			if (getTimeout() != 0) {
+				soft_timeout = getTimeout()*1000;
 				std::ostringstream timeout;
-				timeout << getTimeout()*1000;
+				timeout << soft_timeout;
 				pwrite("(set-option :soft-timeout "+timeout.str()+")\n");
 			}
 		}
@@ -167,6 +167,8 @@ void SMTlib::SMTlib_close() {
 	pwrite("(exit)\n");
 	close(wpipefd[1]); /* Reader will see EOF */
 	close(rpipefd[0]);
+	delete reader;
+	reader = NULL;
 	if (log_file) fclose(log_file);
 	wait(NULL);
 }
@@ -175,10 +177,10 @@ SMTlib::~SMTlib() {
 	SMTlib_close();
 }
 
-void SMTlib::pwrite(std::string s) {
+void SMTlib::pwrite(const std::string & s) {
 	DEBUG(*Out << "WRITING : " << s  << "\n";);
-	// DM pquoi pas s.length() ?
-	if (!write(wpipefd[1], s.c_str(), strlen(s.c_str()))) {
+	query_bytes += s.size();
+	if (!write(wpipefd[1], s.c_str(), s.size())) {
 		*Out << "ERROR WHEN TRYING TO WRITE IN THE SMT-LIB PIPE\n";
 	}
 	if (log_file) {
@@ -190,10 +192,7 @@ void SMTlib::pwrite(std::string s) {
 int SMTlib::pread() {
 	int ret;
 
-	SMTlib2driver driver;
-	driver.parse(input);
-
-	switch (driver.ans) {
+	switch (reader->readAnswer()) {
 		case SAT:
 			ret = 1;
 			break;
@@ -201,7 +200,7 @@ int SMTlib::pread() {
 			ret = 0;
 			break;
 		case UNKNOWN:
-			*Out << "UNKNOWN\n";
+			// printed by SMTpass, once the query is given up
 			ret = -1;
 			break;
 		case ERROR:
@@ -216,12 +215,35 @@ int SMTlib::pread() {
 		default:
 			ret = -1;
 	}
-
-	model.clear();
-	model.insert(driver.model.begin(),driver.model.end());
 	return ret;
 }
 
+/**
+ * \brief true for the Boolean variables whose value is read in the models,
+ * see SMTpass::getElementFromString
+ */
+static bool is_model_variable(const std::string & name) {
+	return name.compare(0, 2, "b_") == 0
+		|| name.compare(0, 3, "bs_") == 0
+		|| name.compare(0, 3, "bd_") == 0
+		|| name.compare(0, 2, "t_") == 0
+		|| name.compare(0, 2, "d_") == 0;
+}
+
+void SMTlib::update_get_value() {
+	if (!get_value_outdated) return;
+	get_value.clear();
+	for (auto & entry : vars) {
+		if (is_model_variable(entry.first)) {
+			get_value += " " + entry.first;
+		}
+	}
+	if (!get_value.empty()) {
+		get_value = "(get-value (" + get_value + "))\n";
+	}
+	get_value_outdated = false;
+}
+
 SMT_expr SMTlib::SMT_mk_true(){
 	return SMT_expr("true");
 }
@@ -238,6 +260,7 @@ SMT_var SMTlib::SMT_mk_bool_var(std::string name){
 		vars[name].stack_level = stack_level;
 		vars[name].declaration = "(declare-fun " + name + " () Bool)\n";
 		pwrite(vars[name].declaration);
+		if (is_model_variable(name)) get_value_outdated = true;
 	}
 	return vars[name].var;
 }
@@ -334,7 +357,20 @@ SMT_expr SMTlib::SMT_mk_num (int n){
 	return SMT_expr(oss.str());
 }
 
+SMT_expr SMTlib::SMT_mk_num_int64 (int64_t n){
+	if (n == INT64_MIN) return SMT_manager::SMT_mk_num_int64(n);
+	char buf[32];
+	if (n < 0)
+		snprintf(buf, sizeof(buf), "(- %lld)", (long long)-n);
+	else
+		snprintf(buf, sizeof(buf), "%lld", (long long)n);
+	return SMT_expr(buf);
+}
+
 SMT_expr SMTlib::SMT_mk_num_mpq (mpq_t mpq) {
+	if (mpz_cmp_ui(mpq_denref(mpq), 1) == 0 && mpz_fits_slong_p(mpq_numref(mpq))) {
+		return SMT_mk_num_int64(mpz_get_si(mpq_numref(mpq)));
+	}
 	SMT_expr res;
 	char * cnum;
 	char * cden;
@@ -603,16 +639,32 @@ int SMTlib::SMT_check(SMT_expr a, std::set<std::string> & true_booleans){
 	DEBUG(
 			*Out << "\n\n" << check_stmt << "\n\n";
 		 );
+	query_bytes = 0;
+	reader->resetStats();
 	pwrite(check_stmt);
 
 	ret = pread();
+	true_booleans.clear();
 	if (ret == 1) {
-		// SAT
-		pwrite("(get-model)\n");
-		pread();
-		true_booleans.clear();
-		true_booleans.insert(model.begin(), model.end());
+		// SAT: we only ask for the values of the variables the engines
+		// read, instead of the whole model
+		update_get_value();
+		if (!get_value.empty()) {
+			pwrite(get_value);
+			if (reader->readTrueValues(true_values)) {
+				for (unsigned id : true_values) {
+					true_booleans.insert(reader->getName(id).str());
+				}
+			} else {
+				// without the values, no path can be extracted from the
+				// model: the answer is unknown
+				*Out << "ERROR: cannot read the values of the SMT solver\n";
+				ret = -1;
+			}
+		}
 	}
+	query_bytes += reader->getBytes();
+	query_parse_time = reader->getParseTime();
 	if (ret == 0) {
 		// UNSAT
 		//pwrite("(get-unsat-core)\n");
@@ -621,6 +673,15 @@ int SMTlib::SMT_check(SMT_expr a, std::set<std::string> & true_booleans){
 	return ret;
 }
 
+std::string SMTlib::SMT_to_smtlib2(SMT_expr a) {
+	std::string res;
+	for (auto & v : vars) {
+		res += v.second.declaration;
+	}
+	res += "(assert " + a.SMTlib() + ")\n";
+	return res;
+}
+
 void SMTlib::push_context() {
 	pwrite("(push 1)\n");
 	stack_level++;
@@ -638,9 +699,39 @@ void SMTlib::pop_context() {
 	}
 	vars.clear();
 	vars.insert(tmpvars.begin(), tmpvars.end());
+	get_value_outdated = true;
 }
 
 bool SMTlib::interrupt() {
 	kill(solver_pid, SIGINT);
 	return true;
 }
+
+bool SMTlib::set_timeout(unsigned ms) {
+	if (getSMTSolver() != Z3 && getSMTSolver() != Z3_QFNRA)
+		return false;
+	unsigned limit = (getTimeout() != 0) ? getTimeout()*1000 : UINT_MAX;
+	if (ms != 0 && ms < limit)
+		limit = ms;
+	if (limit == soft_timeout)
+		return true;
+	soft_timeout = limit;
+	std::ostringstream timeout;
+	timeout << limit;
+	pwrite("(set-option :soft-timeout "+timeout.str()+")\n");
+	return true;
+}
+
+size_t SMTlib::memory_usage() {
+	if (solver_pid <= 0) return 0;
+	std::ostringstream filename;
+	filename << "/proc/" << solver_pid << "/status";
+	std::ifstream status(filename.str().c_str());
+	std::string line;
+	while (std::getline(status, line)) {
+		// VmRSS:	  1234 kB
+		if (line.compare(0, 6, "VmRSS:") == 0)
+			return (size_t)std::strtoull(line.c_str() + 6, NULL, 10) * 1024;
+	}
+	return 0;
+}
@@ -12,6 +12,7 @@
 #include <string>
 
 #include "SMT_manager.h"
+#include "SMTlib2reader.h"
 
 #define LOG_SMT 0
 
@@ -38,10 +39,27 @@ class SMTlib: public SMT_manager {
 
 		std::map<std::string,struct definedvars> vars;
 
-		std::set<std::string> model;
+		/**
+		 * \brief get-value command asking the values of the Boolean
+		 * variables the engines read in the models (blocks, edges,
+		 * disjunct indices), rebuilt when they change
+		 */
+		std::string get_value;
+		bool get_value_outdated;
+
+		/**
+		 * \brief ids of the variables that are true in the last reply
+		 */
+		std::vector<unsigned> true_values;
 
 		int stack_level;
 
+		/**
+		 * \brief current :soft-timeout of Z3, in milliseconds, UINT_MAX
+		 * if there is no limit
+		 */
+		unsigned soft_timeout;
+
 		/**
 		 * pipe from PAGAI to the SMT solver
 		 */
@@ -51,11 +69,13 @@ class SMTlib: public SMT_manager {
 		 */
 		int rpipefd[2];
 
-		FILE *input;
+		SMTlib2reader * reader;
 
-		void pwrite(std::string s);
+		void pwrite(const std::string & s);
 		int pread();
 
+		void update_get_value();
+
 		FILE *log_file;
 
 		pid_t solver_pid;
@@ -82,6 +102,7 @@ class SMTlib: public SMT_manager {
 
 		SMT_expr SMT_mk_num (int n);
 		SMT_expr SMT_mk_num_mpq (mpq_t mpq);
+		SMT_expr SMT_mk_num_int64 (int64_t n);
 		SMT_expr SMT_mk_real (double x);
 
 		SMT_expr SMT_mk_sum (std::vector<SMT_expr> args);
@@ -119,6 +140,17 @@ class SMTlib: public SMT_manager {
 		void SMT_print(SMT_expr a);
 		void SMT_assert(SMT_expr a);
 		int SMT_check(SMT_expr a, std::set<std::string> & true_booleans);
+		std::string SMT_to_smtlib2(SMT_expr a);
 		bool interrupt();
+
+		/**
+		 * \brief only supported by Z3, with :soft-timeout
+		 */
+		bool set_timeout(unsigned ms);
+
+		/**
+		 * \brief resident memory of the solver process
+		 */
+		size_t memory_usage();
 };
 #endif
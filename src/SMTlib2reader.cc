@@ -0,0 +1,229 @@
+/**
+ * \file SMTlib2reader.cc
+ * \brief Implementation of the SMTlib2reader class
+ * \author agent
+ */
+#include <cctype>
+#include <cerrno>
+
+#include <unistd.h>
+
+#include "SMTlib2reader.h"
+
+using namespace llvm;
+
+SMTlib2reader::SMTlib2reader(int fd) : fd(fd), buffer(1 << 16), pos(0), end(0), bytes(0),
+	parse_time(Duration::zero()), wait_time(Duration::zero()) {
+	id_sat = intern("sat");
+	id_unsat = intern("unsat");
+	id_unknown = intern("unknown");
+	id_success = intern("success");
+	id_error = intern("error");
+}
+
+unsigned SMTlib2reader::intern(StringRef name) {
+	StringMap<unsigned>::iterator it = ids.find(name);
+	if (it != ids.end()) return it->second;
+	unsigned id = names.size();
+	ids[name] = id;
+	// the key stored in the map lives as long as the map
+	names.push_back(ids.find(name)->getKey());
+	return id;
+}
+
+void SMTlib2reader::resetStats() {
+	bytes = 0;
+	parse_time = Duration::zero();
+}
+
+bool SMTlib2reader::fill() {
+	if (pos < end) return true;
+	ssize_t n;
+	TimePoint start = time_now();
+	do {
+		n = read(fd, buffer.data(), buffer.size());
+	} while (n < 0 && errno == EINTR);
+	wait_time += time_now() - start;
+	if (n <= 0) return false;
+	pos = 0;
+	end = n;
+	bytes += n;
+	return true;
+}
+
+int SMTlib2reader::get() {
+	if (!fill()) return -1;
+	return (unsigned char)buffer[pos++];
+}
+
+int SMTlib2reader::peek() {
+	if (!fill()) return -1;
+	return (unsigned char)buffer[pos];
+}
+
+SMTlib2reader::token_kind SMTlib2reader::next() {
+	for (;;) {
+		int c = get();
+		if (c < 0) return END;
+		if (isspace(c)) continue;
+		if (c == ';') {
+			// comment
+			while ((c = get()) >= 0 && c != '\n') {}
+			continue;
+		}
+		if (c == '(') return LEFTPAR;
+		if (c == ')') return RIGHTPAR;
+		text.clear();
+		if (c == '"') {
+			for (;;) {
+				c = get();
+				if (c < 0) return END;
+				if (c == '"') {
+					// "" is an escaped quote since SMT-lib 2.5
+					if (peek() != '"') break;
+					c = get();
+				} else if (c == '\\' && peek() == '"') {
+					c = get();
+				}
+				text += (char)c;
+			}
+			return STRING;
+		}
+		if (c == '|') {
+			while ((c = get()) >= 0 && c != '|') text += (char)c;
+			return SYMBOL;
+		}
+		text += (char)c;
+		while ((c = peek()) >= 0 && !isspace(c)
+				&& c != '(' && c != ')' && c != ';' && c != '"' && c != '|') {
+			text += (char)c;
+			pos++;
+		}
+		return SYMBOL;
+	}
+}
+
+bool SMTlib2reader::skipTerm(int depth) {
+	while (depth > 0) {
+		switch (next()) {
+			case LEFTPAR:
+				depth++;
+				break;
+			case RIGHTPAR:
+				depth--;
+				break;
+			case END:
+				return false;
+			default:
+				break;
+		}
+	}
+	return true;
+}
+
+void SMTlib2reader::skipReply(int depth, token_kind last) {
+	switch (last) {
+		case LEFTPAR:
+			depth++;
+			break;
+		case RIGHTPAR:
+			depth--;
+			break;
+		case END:
+			return;
+		default:
+			break;
+	}
+	if (depth > 0) skipTerm(depth);
+}
+
+SMTans SMTlib2reader::parseAnswer() {
+	for (;;) {
+		switch (next()) {
+			case SYMBOL:
+				{
+					unsigned id = symbol();
+					if (id == id_success) continue;
+					if (id == id_sat) return SAT;
+					if (id == id_unsat) return UNSAT;
+					if (id == id_unknown) return UNKNOWN;
+					*Out << "unexpected reply of the SMT solver: " << text << "\n";
+					return ERROR;
+				}
+			case LEFTPAR:
+				// (error "message")
+				if (next() == SYMBOL && symbol() == id_error && next() == STRING) {
+					*Out << text << "\n";
+					skipTerm();
+				}
+				return ERROR;
+			default:
+				return ERROR;
+		}
+	}
+}
+
+bool SMTlib2reader::parseTrueValues(std::vector<unsigned> & true_ids) {
+	true_ids.clear();
+	if (next() != LEFTPAR) return false;
+	for (;;) {
+		token_kind t = next();
+		if (t == RIGHTPAR) return true;
+		if (t == SYMBOL && symbol() == id_error) {
+			t = next();
+			if (t == STRING) {
+				*Out << text << "\n";
+				t = next();
+			}
+			skipReply(1, t);
+			return false;
+		}
+		if (t != LEFTPAR) {
+			skipReply(1, t);
+			return false;
+		}
+
+		// (term value)
+		t = next();
+		bool literal = (t == SYMBOL);
+		unsigned id = 0;
+		if (literal) {
+			id = symbol();
+		} else if (t != LEFTPAR) {
+			skipReply(2, t);
+			return false;
+		} else if (!skipTerm()) {
+			return false;
+		}
+		t = next();
+		if (t == SYMBOL) {
+			if (literal && text == "true") true_ids.push_back(id);
+		} else if (t != LEFTPAR) {
+			skipReply(2, t);
+			return false;
+		} else if (!skipTerm()) {
+			return false;
+		}
+		t = next();
+		if (t != RIGHTPAR) {
+			skipReply(2, t);
+			return false;
+		}
+	}
+}
+
+SMTans SMTlib2reader::readAnswer() {
+	TimePoint start = time_now();
+	Duration wait = wait_time;
+	SMTans res = parseAnswer();
+	parse_time += (time_now() - start) - (wait_time - wait);
+	return res;
+}
+
+bool SMTlib2reader::readTrueValues(std::vector<unsigned> & true_ids) {
+	TimePoint start = time_now();
+	Duration wait = wait_time;
+	bool res = parseTrueValues(true_ids);
+	parse_time += (time_now() - start) - (wait_time - wait);
+	return res;
+}
@@ -0,0 +1,134 @@
+/**
+ * \file SMTlib2reader.h
+ * \brief Declaration of the SMTlib2reader class
+ * \author agent
+ */
+#ifndef _SMTLIB2READER_H
+#define _SMTLIB2READER_H
+
+#include <string>
+#include <vector>
+
+#include "begin_3rdparty.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "end_3rdparty.h"
+
+#include "Debug.h"
+
+typedef enum {
+	SAT,
+	UNSAT,
+	UNKNOWN,
+	ERROR
+} SMTans;
+
+/**
+ * \class SMTlib2reader
+ * \brief reads the replies of an SMT-lib2 solver from a pipe
+ *
+ * The replies are read into a buffer that is reused for the whole life of
+ * the solver. Symbols are interned: each distinct symbol gets an id the
+ * first time it is read, so that reading a reply does not allocate once all
+ * the symbols have been seen.
+ */
+class SMTlib2reader {
+
+	private:
+		enum token_kind {
+			LEFTPAR,
+			RIGHTPAR,
+			SYMBOL,
+			STRING,
+			END
+		};
+
+		int fd;
+
+		std::vector<char> buffer;
+		size_t pos;
+		size_t end;
+
+		/**
+		 * \brief text of the last symbol or string
+		 */
+		std::string text;
+
+		llvm::StringMap<unsigned> ids;
+		std::vector<llvm::StringRef> names;
+
+		/**
+		 * \brief bytes read and time spent parsing them (without waiting
+		 * for the solver), since the last resetStats
+		 */
+		size_t bytes;
+		Duration parse_time;
+		Duration wait_time;
+
+		// ids of the reserved words
+		unsigned id_sat, id_unsat, id_unknown, id_success, id_error;
+
+		/**
+		 * \brief reads more bytes from the pipe
+		 * \return false at the end of the pipe
+		 */
+		bool fill();
+
+		/**
+		 * \brief next character, -1 at the end of the pipe
+		 */
+		int get();
+		int peek();
+
+		/**
+		 * \brief reads the next token, the text of a symbol or a string is
+		 * in text
+		 */
+		token_kind next();
+
+		/**
+		 * \brief id of the symbol that has just been read
+		 */
+		unsigned symbol() {return intern(text);}
+
+		/**
+		 * \brief skips the end of a term whose left parenthesis has been
+		 * read, depth being the number of open parentheses
+		 */
+		bool skipTerm(int depth = 1);
+
+		/**
+		 * \brief skips the rest of a malformed reply, so that the next
+		 * reply is read from its beginning. depth is the number of open
+		 * parentheses before the unexpected token last.
+		 */
+		void skipReply(int depth, token_kind last);
+
+		SMTans parseAnswer();
+		bool parseTrueValues(std::vector<unsigned> & true_ids);
+
+	public:
+		SMTlib2reader(int fd);
+
+		unsigned intern(llvm::StringRef name);
+		llvm::StringRef getName(unsigned id) {return names[id];}
+
+		size_t getBytes() {return bytes;}
+		Duration getParseTime() {return parse_time;}
+		void resetStats();
+
+		/**
+		 * \brief reads the reply to a check-sat
+		 */
+		SMTans readAnswer();
+
+		/**
+		 * \brief reads the reply to a get-value, and gives the ids of the
+		 * symbols whose value is true
+		 * \return false if the reply is an error or is malformed, the
+		 * whole reply is read anyway
+		 */
+		bool readTrueValues(std::vector<unsigned> & true_ids);
+};
+
+#endif
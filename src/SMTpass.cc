@@ -3,6 +3,7 @@
  * \brief Implementation of the SMTpass pass
  * \author Julien Henry
  */
+#include <algorithm>
 #include <sstream>
 #include <vector>
 #include <queue>
@@ -10,6 +11,7 @@
 #include <string>
 #include <limits>
 #include <cmath>
+#include <cstdint>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
@@ -28,6 +30,8 @@
 #include "Expr.h"
 #include "apron.h"
 #include "Debug.h"
+#include "Trace.h"
+#include "ExtractChecks.h"
 
 /*
 DM: If set to 0, modulo (grid) constraints are not converted to SMT.
@@ -45,6 +49,7 @@ std::map<int,BasicBlock*> NodeAddress;
 int CurrentNodeName;
 
 int SMTpass::nundef = 0;
+std::map<Value*,unsigned> SMTpass::query_levels;
 
 SMTpass::SMTpass() {
 	switch (getSMTSolver()) {
@@ -63,10 +68,29 @@ SMTpass::SMTpass() {
 	}
 	stack_level = 0;
 	CurrentNodeName = 0;
+	capture = SMTcapture::enabled() ? new SMTcapture() : NULL;
+
+	query_source = NULL;
+	unsigned budget = std::max(getSMTBudget(), 0);
+	unsigned limit = getTimeout()*1000;
+	if (budget != 0 && man->set_timeout(0)) {
+		// the path queries may need a lot of time, their budget grows
+		// slowly. The inclusion queries are small: either they are solved
+		// quickly, or they directly get the whole time.
+		unsigned b = budget;
+		for (int i = 0; i < 3 && (limit == 0 || b < limit); i++, b *= 4)
+			budgets[PATH_QUERY].push_back(b);
+		if (limit == 0 || budget/5 < limit)
+			budgets[INCLUSION_QUERY].push_back(std::max(budget/5, 1u));
+	}
+	budgets[PATH_QUERY].push_back(0);
+	budgets[INCLUSION_QUERY].push_back(0);
+	clear_numeral_cache();
 }
 
 SMTpass::~SMTpass() {
 	delete man;
+	delete capture;
 }
 
 SMTpass * instance = NULL;
@@ -103,6 +127,11 @@ SMT_expr SMTpass::getRho(Function &F) {
 
 void SMTpass::reset_SMTcontext() {
 	rho.clear();
+	rho_guard.clear();
+	rho_owner.clear();
+	rho_slice.clear();
+	clear_numeral_cache();
+	if (capture != NULL) capture->clear();
 #if 0
 	while (stack_level > 0)
 		pop_context();
@@ -157,12 +186,11 @@ SMT_expr SMTpass::linexpr1ToSmt(BasicBlock* b, ap_linexpr1_t linexpr, bool &inte
 		if (!((Value*)var)->getType()->isIntegerTy()) {
 			// check if the coeff associated to this non-int variable is != 0
 			// if it is, then the expression has to be of type real
-			coefficient = scalarToSmt(coeff->val.scalar,integer,value,infinity);
-			if (infinity) {
+			if (ap_scalar_infty(coeff->val.scalar)) {
 				skip = true;
 				return man->SMT_mk_num(0);
 			}
-			if (value != 0) {
+			if (ap_scalar_sgn(coeff->val.scalar) != 0) {
 				integer = false;
 			}
 		}
@@ -175,42 +203,104 @@ SMT_expr SMTpass::linexpr1ToSmt(BasicBlock* b, ap_linexpr1_t linexpr, bool &inte
 		} else {
 			primed = false;
 		}
+		// the value computed by scalarToSmt is rounded: test the scalar
+		// itself, so that a coefficient close to 0 or 1 is kept
+		if (ap_scalar_sgn(coeff->val.scalar) == 0)
+			continue;
 		val = getValueExpr((Value*)var, primed);
 
 		if ( !integer && ((Value*)var)->getType()->isIntegerTy()) {
 			val = man->SMT_mk_int2real(val);
 		}
 
+		if (ap_scalar_equal_int(coeff->val.scalar, 1)) {
+			elts.push_back(val);
+			continue;
+		}
 		coefficient = scalarToSmt(coeff->val.scalar,integer,value,infinity);
 		if (infinity) {
 			skip = true;
 			return man->SMT_mk_num(0);
 		}
-
-		switch ((int)value) {
-			case 0:
-				break;
-			case 1:
-				elts.push_back(val);
-				break;
-			default:
-				elts.push_back(man->SMT_mk_mul(val,coefficient));
-				break;
-		}
+		elts.push_back(man->SMT_mk_mul(val,coefficient));
 	}
 	coeff = ap_linexpr1_cstref(&linexpr);
-	coefficient = scalarToSmt(coeff->val.scalar,integer,value,infinity);
-	if (infinity) {
-		skip = true;
-		return man->SMT_mk_num(0);
-	}
-	if (value != 0)
+	if (ap_scalar_sgn(coeff->val.scalar) != 0) {
+		coefficient = scalarToSmt(coeff->val.scalar,integer,value,infinity);
+		if (infinity) {
+			skip = true;
+			return man->SMT_mk_num(0);
+		}
 		elts.push_back(coefficient);
+	}
 
 	return man->SMT_mk_sum(elts);
 }
 
+/**
+ * \brief integers whose conversion to double is exact
+ */
+#define EXACT_INT_BOUND (INT64_C(1) << 53)
+
+/**
+ * \brief n is the value of the scalar if it is an integer in
+ * [-EXACT_INT_BOUND, EXACT_INT_BOUND]
+ */
+static bool scalar_to_int64(ap_scalar_t * scalar, int64_t & n) {
+	switch (scalar->discr) {
+		case AP_SCALAR_MPQ:
+			if (mpz_cmp_ui(mpq_denref(scalar->val.mpq), 1) != 0
+					|| !mpz_fits_slong_p(mpq_numref(scalar->val.mpq)))
+				return false;
+			n = mpz_get_si(mpq_numref(scalar->val.mpq));
+			break;
+		case AP_SCALAR_DOUBLE:
+			{
+				double d = scalar->val.dbl;
+				if (!(d >= -EXACT_INT_BOUND && d <= EXACT_INT_BOUND) || d != std::floor(d))
+					return false;
+				n = (int64_t)d;
+				break;
+			}
+		default:
+			return false;
+	}
+	return n >= -EXACT_INT_BOUND && n <= EXACT_INT_BOUND;
+}
+
+void SMTpass::clear_numeral_cache() {
+	for (unsigned k = 0; k < numeral_cache_size; k++) {
+		numeral_cache[k].valid = false;
+		numeral_cache[k].expr = SMT_expr();
+	}
+}
+
+SMT_expr SMTpass::numeralToSmt(int64_t n, bool integer) {
+	numeral_cache_entry & entry =
+		numeral_cache[((uint64_t)n * 2 + integer) % numeral_cache_size];
+	if (entry.valid && entry.n == n && entry.integer == integer) {
+		return entry.expr;
+	}
+	entry.valid = true;
+	entry.n = n;
+	entry.integer = integer;
+	if (integer) {
+		entry.expr = man->SMT_mk_num_int64(n);
+	} else {
+		entry.expr = man->SMT_mk_real((double)n);
+	}
+	return entry.expr;
+}
+
 SMT_expr SMTpass::scalarToSmt(ap_scalar_t * scalar, bool integer, double &value, bool &infinity) {
+	// fast path for the small integers, the most common coefficients
+	int64_t n;
+	if (scalar_to_int64(scalar, n)) {
+		infinity = false;
+		value = (double)n;
+		return numeralToSmt(n, integer);
+	}
+
 	mp_rnd_t round = GMP_RNDU;
 	ap_double_set_scalar(&value,scalar,round);
 	if (std::isinf(value)) {
@@ -220,6 +310,9 @@ SMT_expr SMTpass::scalarToSmt(ap_scalar_t * scalar, bool integer, double &value,
 	}
 	infinity = false;
 	if (integer) {
+		if (scalar->discr == AP_SCALAR_MPQ) {
+			return man->SMT_mk_num_mpq(scalar->val.mpq);
+		}
 		mpq_t mpq;
 		mpq_init(mpq);
 		ap_mpq_set_scalar(mpq,scalar,round);
@@ -384,6 +477,14 @@ const std::string SMTpass::getUndeterministicChoiceName(Value * v) {
 	return name.str();
 }
 
+const std::string SMTpass::getRhoGuardName(BasicBlock * b) {
+	return "a_" + getNodeSubName(b);
+}
+
+const std::string SMTpass::getSourceCounterName(BasicBlock * b) {
+	return "o_" + getNodeSubName(b);
+}
+
 const std::string SMTpass::getNodeSubName(BasicBlock * b) {
 	if (NodeNames.count(b) == 0) {
 		NodeNames[b] = CurrentNodeName;
@@ -628,35 +729,57 @@ void SMTpass::getElementFromString(
 	}
 }
 
+/**
+ * \brief computes reach[b], the sorted ids of the blocks of Pr reachable from
+ * the block of id b by a path whose intermediate blocks are not in Pr
+ *
+ * The blocks not in Pr do not form any reachable cycle, so each block is
+ * visited once.
+ */
+static void computePrReach(
+		const BlockGraph & G,
+		const std::vector<bool> & inPr,
+		unsigned b,
+		std::vector<std::vector<unsigned> > & reach,
+		std::vector<bool> & visited) {
+	visited[b] = true;
+	std::vector<unsigned> & R = reach[b];
+	BasicBlock * bb = G.getBlock(b);
+	for (succ_iterator it = succ_begin(bb), E = succ_end(bb); it != E; ++it) {
+		unsigned s = G.getId(*it);
+		if (inPr[s]) {
+			R.push_back(s);
+			continue;
+		}
+		if (s == b) continue;
+		if (!visited[s]) computePrReach(G, inPr, s, reach, visited);
+		R.insert(R.end(), reach[s].begin(), reach[s].end());
+	}
+	std::sort(R.begin(), R.end());
+	R.erase(std::unique(R.begin(), R.end()), R.end());
+}
+
 void SMTpass::computePrSuccAndPred(Function & F) {
 	Pr * FPr = Pr::getInstance(&F);
-	for (BasicBlock * dest : FPr->getPr()) {
-		int counter = 0;
-		std::set<BasicBlock*> visited;
-		std::queue<BasicBlock*> ToBeComputed;
-		ToBeComputed.push(dest);
-		while (!ToBeComputed.empty()) {
-			counter++;
-			BasicBlock * b = ToBeComputed.front();
-			ToBeComputed.pop();
-			if (visited.count(b)) continue;
-			visited.insert(b);
-			if (!FPr->inPr(b) || b == dest) {
-				BasicBlock * pred;
-				for (pred_iterator p = pred_begin(b); p != pred_end(b); ++p) {
-					pred = *p;
-					if (!FPr->inPr(pred)) {
-						if (!visited.count(pred)) {
-							ToBeComputed.push(pred);
-						}
-					} else {
-						FPr->Pr_pred[dest].insert(pred);
-						FPr->Pr_succ[pred].insert(dest);
-					}
-				}
-			}
+	BlockGraph & G = FPr->Pr_graph;
+	G.init(&F);
+
+	std::vector<bool> inPr(G.size(), false);
+	for (BasicBlock * b : FPr->getPr()) {
+		inPr[G.getId(b)] = true;
+	}
+
+	std::vector<std::vector<unsigned> > reach(G.size());
+	std::vector<bool> visited(G.size(), false);
+	std::vector<std::pair<unsigned,unsigned> > edges;
+	for (BasicBlock * b : FPr->getPr()) {
+		unsigned src = G.getId(b);
+		computePrReach(G, inPr, src, reach, visited);
+		for (unsigned dest : reach[src]) {
+			edges.push_back(std::make_pair(src, dest));
 		}
 	}
+	G.setEdges(edges);
 }
 
 void SMTpass::computeRhoRec(Function &F,
@@ -688,6 +811,7 @@ void SMTpass::computeRhoRec(Function &F,
 		}
 
 		if (first) continue;
+		rho_owner[b] = dest;
 
 		// we create a boolean reachability predicate for the basicblock
 		SMT_var bvar = man->SMT_mk_bool_var(getNodeName(b,false));
@@ -706,7 +830,7 @@ void SMTpass::computeRhoRec(Function &F,
 
 		SMT_expr bvar_exp = man->SMT_mk_expr_from_bool_var(bvar);
 		bvar_exp = man->SMT_mk_eq(bvar_exp,bpredicate);
-		rho_components.push_back(bvar_exp);
+		addControlComponent(bvar_exp);
 		// we compute the transformation due to the basicblock's
 		// instructions
 		bvar = man->SMT_mk_bool_var(getNodeName(b,false));
@@ -725,37 +849,201 @@ void SMTpass::computeRhoRec(Function &F,
 			implies.push_back(bvar_exp);
 			implies.push_back(bpredicate);
 			bvar_exp = man->SMT_mk_or(implies);
-			rho_components.push_back(bvar_exp);
+			addControlComponent(bvar_exp);
 		}
 	}
 }
 
+void SMTpass::addControlComponent(SMT_expr e) {
+	if (rhoSlices())
+		rho_control.push_back(e);
+	else
+		rho_components.push_back(e);
+}
+
 void SMTpass::computeRho(Function &F) {
 	Pr * FPr = Pr::getInstance(&F);
 
 	rho_components.clear();
 	std::set<BasicBlock*> visited;
-	for (BasicBlock * bb : FPr->getPr()) {
-		computeRhoRec(F, visited, bb);
+	if (!rhoSlices()) {
+		for (BasicBlock * bb : FPr->getPr()) {
+			computeRhoRec(F, visited, bb);
+		}
+		rho_components.push_back(computeAtMostOneSource(F));
+		rho[&F] = man->SMT_mk_and(rho_components);
+	} else {
+		// only the reachability of the blocks and edges is guarded, the
+		// definitions of the values stay in rho_components
+		std::vector<SMT_expr> parts;
+		for (BasicBlock * bb : FPr->getPr()) {
+			computeRhoRec(F, visited, bb);
+			SMT_var avar = man->SMT_mk_bool_var(getRhoGuardName(bb));
+			SMT_expr guard = man->SMT_mk_expr_from_bool_var(avar);
+			rho_guard[bb] = guard;
+			if (rho_control.empty()) continue;
+			std::vector<SMT_expr> implies;
+			implies.push_back(man->SMT_mk_not(guard));
+			implies.push_back(man->SMT_mk_and(rho_control));
+			parts.push_back(man->SMT_mk_or(implies));
+			rho_control.clear();
+		}
+		if (!rho_components.empty())
+			parts.push_back(man->SMT_mk_and(rho_components));
+		parts.push_back(computeAtMostOneSource(F));
+		rho[&F] = man->SMT_mk_and(parts);
 	}
-	rho[&F] = man->SMT_mk_and(rho_components);
 	rho_components.clear();
+	rho_control.clear();
 	computePrSuccAndPred(F);
 }
 
+SMT_expr SMTpass::computeAtMostOneSource(Function &F) {
+	Pr * FPr = Pr::getInstance(&F);
+	std::vector<SMT_expr> clauses;
+	SMT_expr previous;
+	for (BasicBlock * bb : FPr->getPr()) {
+		SMT_var bvar = man->SMT_mk_bool_var(getNodeName(bb, true));
+		SMT_expr source = man->SMT_mk_expr_from_bool_var(bvar);
+		SMT_var ovar = man->SMT_mk_bool_var(getSourceCounterName(bb));
+		SMT_expr counter = man->SMT_mk_expr_from_bool_var(ovar);
+
+		// bs_X => o_X
+		std::vector<SMT_expr> clause;
+		clause.push_back(man->SMT_mk_not(source));
+		clause.push_back(counter);
+		clauses.push_back(man->SMT_mk_or(clause));
+		if (!previous.is_empty()) {
+			// o_prev => o_X
+			clause.clear();
+			clause.push_back(man->SMT_mk_not(previous));
+			clause.push_back(counter);
+			clauses.push_back(man->SMT_mk_or(clause));
+			// o_prev => not bs_X
+			clause.clear();
+			clause.push_back(man->SMT_mk_not(previous));
+			clause.push_back(man->SMT_mk_not(source));
+			clauses.push_back(man->SMT_mk_or(clause));
+		}
+		previous = counter;
+	}
+	return man->SMT_mk_and(clauses);
+}
+
+SMT_expr SMTpass::getRhoSlice(BasicBlock * source) {
+	if (rho_slice.count(source)) return rho_slice[source];
+	Pr * FPr = Pr::getInstance(source->getParent());
+
+	// region of source: the blocks reachable from source without crossing
+	// another block of Pr, and the blocks of Pr where these paths end
+	std::set<BasicBlock*> region;
+	std::set<BasicBlock*> ends;
+	std::vector<BasicBlock*> stack(1, source);
+	region.insert(source);
+	while (!stack.empty()) {
+		BasicBlock * b = stack.back();
+		stack.pop_back();
+		for (BasicBlock * succ : FPr->getCFGSuccessors(b)) {
+			if (FPr->inPr(succ)) {
+				ends.insert(succ);
+			} else if (!region.count(succ)) {
+				region.insert(succ);
+				stack.push_back(succ);
+			}
+		}
+	}
+
+	std::set<BasicBlock*> parts;
+	std::vector<SMT_expr> slice;
+	for (BasicBlock * b : region) {
+		if (rho_owner.count(b)) parts.insert(rho_owner[b]);
+	}
+	for (BasicBlock * b : ends) {
+		if (rho_owner.count(b)) parts.insert(rho_owner[b]);
+	}
+	for (BasicBlock * p : parts) {
+		slice.push_back(rho_guard[p]);
+	}
+	for (BasicBlock * b : region) {
+		if (b == source) continue;
+		for (BasicBlock * pred : FPr->getCFGPredecessors(b)) {
+			if (region.count(pred)) continue;
+			SMT_var evar = man->SMT_mk_bool_var(getEdgeName(pred, b));
+			slice.push_back(man->SMT_mk_not(man->SMT_mk_expr_from_bool_var(evar)));
+		}
+	}
+	for (BasicBlock * b : ends) {
+		for (BasicBlock * pred : FPr->getCFGPredecessors(b)) {
+			if (region.count(pred)) continue;
+			SMT_var evar = man->SMT_mk_bool_var(getEdgeName(pred, b));
+			slice.push_back(man->SMT_mk_not(man->SMT_mk_expr_from_bool_var(evar)));
+		}
+	}
+	SMT_expr res = man->SMT_mk_and(slice);
+	rho_slice[source] = res;
+	return res;
+}
+
 
 void SMTpass::push_context() {
 	stack_level++;
 	man->push_context();
+	if (capture != NULL) capture->push_context();
 }
 
 void SMTpass::pop_context() {
 	stack_level--;
 	man->pop_context();
+	if (capture != NULL) capture->pop_context();
 }
 
 void SMTpass::SMT_assert(SMT_expr expr) {
 	man->SMT_assert(expr);
+	if (capture != NULL) capture->SMT_assert(expr);
+}
+
+int SMTpass::check_once(SMT_expr expr, std::set<std::string> & true_booleans) {
+	if (capture == NULL)
+		return man->SMT_check(expr, true_booleans);
+	TimePoint start_time = time_now();
+	int res = man->SMT_check(expr, true_booleans);
+	capture->SMT_check(man, expr, res, time_now() - start_time);
+	return res;
+}
+
+int SMTpass::SMT_check(
+		SMT_expr expr,
+		std::set<std::string> & true_booleans,
+		SMTQueryKind kind) {
+	const std::vector<unsigned> & budget = budgets[kind];
+	// the inclusion queries have no source
+	Value * source = (kind == PATH_QUERY) ? query_source : NULL;
+	query_source = NULL;
+
+	int res;
+	unsigned level = 0;
+	std::map<Value*,unsigned>::iterator memo = query_levels.find(source);
+	if (source != NULL && memo != query_levels.end() && memo->second > 0) {
+		level = memo->second;
+		smt_escalations_count++;
+	}
+
+	while (true) {
+		man->set_timeout(budget[level]);
+		res = check_once(expr, true_booleans);
+		if (res != -1 || level+1 == budget.size()) break;
+		// the formula is asserted again by the next check, which is
+		// harmless: the callers pop it afterwards
+		level++;
+		smt_retries_count++;
+	}
+
+	// an unknown answer was given with the last budget
+	if (source != NULL)
+		query_levels[source] = level;
+	if (res == -1)
+		*Out << "UNKNOWN\n";
+	return res;
 }
 
 SMT_expr SMTpass::createSMTformula(
@@ -771,13 +1059,14 @@ SMT_expr SMTpass::createSMTformula(
 	SMT_var bvar = man->SMT_mk_bool_var(getNodeName(source,true));
 	formula.push_back(man->SMT_mk_expr_from_bool_var(bvar));
 
-	for (BasicBlock * bb : FPr->getPr()) {
-		if (bb != source) {
-			bvar = man->SMT_mk_bool_var(getNodeName(bb, true));
-			formula.push_back(man->SMT_mk_not(man->SMT_mk_expr_from_bool_var(bvar)));
-		}
+	if (rhoSlices()) {
+		getRho(F);
+		formula.push_back(getRhoSlice(source));
 	}
 
+	// the other source nodes are false, by the at most one constraint of
+	// rho
+
 	Abstract * A = Nodes[source]->X_s[t];
 	if (AbstractDisj * Adis = dynamic_cast<AbstractDisj*>(A)) {
 		formula.push_back(AbstractDisjToSmt(NULL, Adis, true));
@@ -810,6 +1099,85 @@ SMT_expr SMTpass::createSMTformula(
 	if (!constraint.is_empty())
 		formula.push_back(constraint);
 
+	smt_queries[t][&F]++;
+	smt_query_assertions[t][&F] += formula.size();
+	query_source = source;
+	return man->SMT_mk_and(formula);
+}
+
+std::vector<SMT_expr> SMTpass::createPathCubes(BasicBlock * source, unsigned k) {
+	Pr * FPr = Pr::getInstance(source->getParent());
+	std::vector<SMT_expr> literals;
+	std::set<BasicBlock*> region;
+	std::vector<BasicBlock*> stack(1, source);
+	region.insert(source);
+	while (!stack.empty() && literals.size() < k) {
+		BasicBlock * b = stack.back();
+		stack.pop_back();
+		std::vector<BasicBlock*> succs;
+		for (BasicBlock * succ : FPr->getCFGSuccessors(b)) {
+			succs.push_back(succ);
+		}
+		if (succs.size() > 1 && succs[0] != succs[1]) {
+			SMT_var evar = man->SMT_mk_bool_var(getEdgeName(b, succs[0]));
+			literals.push_back(man->SMT_mk_expr_from_bool_var(evar));
+		}
+		// the first successor is visited first
+		for (auto it = succs.rbegin(); it != succs.rend(); ++it) {
+			if (FPr->inPr(*it) || region.count(*it)) continue;
+			region.insert(*it);
+			stack.push_back(*it);
+		}
+	}
+
+	std::vector<SMT_expr> cubes;
+	for (unsigned i = 0; i < (1u << literals.size()); i++) {
+		std::vector<SMT_expr> cube;
+		for (unsigned j = 0; j < literals.size(); j++) {
+			if (i & (1u << j))
+				cube.push_back(man->SMT_mk_not(literals[j]));
+			else
+				cube.push_back(literals[j]);
+		}
+		cubes.push_back(cube.empty() ? man->SMT_mk_true() : man->SMT_mk_and(cube));
+	}
+	return cubes;
+}
+
+SMT_expr SMTpass::createInvariantsFormula(Function * F, params t) {
+	Pr * FPr = Pr::getInstance(F);
+	std::vector<SMT_expr> Or;
+	if (rhoSlices()) getRho(*F);
+
+	for (BasicBlock * bb : FPr->getPr()) {
+		Abstract * A = Nodes[bb]->X_s[t];
+		if (A == NULL || A->is_bottom()) continue;
+		std::vector<SMT_expr> source;
+		SMT_var bvar = man->SMT_mk_bool_var(getNodeName(bb,true));
+		source.push_back(man->SMT_mk_expr_from_bool_var(bvar));
+		if (rhoSlices())
+			source.push_back(getRhoSlice(bb));
+		if (AbstractDisj * Adis = dynamic_cast<AbstractDisj*>(A)) {
+			source.push_back(AbstractDisjToSmt(NULL, Adis, false));
+		} else {
+			source.push_back(AbstractToSmt(NULL, A));
+		}
+		Or.push_back(man->SMT_mk_and(source));
+	}
+	// no reachable source: nothing is reachable
+	if (Or.empty())
+		return man->SMT_mk_false();
+	return man->SMT_mk_or(Or);
+}
+
+SMT_expr SMTpass::createCheckFormula(CallInst * check) {
+	std::vector<SMT_expr> formula;
+	BasicBlock * b = check->getParent();
+	// the values of the block are computed from the source when b is in Pr
+	SMT_var bvar = man->SMT_mk_bool_var(getNodeName(b,true));
+	formula.push_back(man->SMT_mk_expr_from_bool_var(bvar));
+	formula.push_back(getValueExpr(ExtractChecks::getCheckCondition(check), false));
+	query_source = check;
 	return man->SMT_mk_and(formula);
 }
 
@@ -835,9 +1203,14 @@ int SMTpass::SMTsolve(
 
 	TimePoint start_time = time_now();
 
-	res = man->SMT_check(expr, true_booleans);
+	{
+		TraceSpan span("SMTsolve", F, passID);
+		res = SMT_check(expr, true_booleans, PATH_QUERY);
+	}
 
 	Total_time_SMT[passID][F] += time_now() - start_time;
+	smt_pipe_bytes[passID][F] += man->query_bytes;
+	Total_time_SMT_parse[passID][F] += man->query_parse_time;
 
 	if (res != 1) return res;
 	bool isEdge, isIndex, start;
@@ -856,7 +1229,6 @@ int SMTpass::SMTsolve(
 				path.push_back(src);
 			}
 		}
-		Out->flush();
 	}
 
 	while (succ.count(path.back())) {
@@ -866,9 +1238,9 @@ int SMTpass::SMTsolve(
 	return res;
 }
 
-int SMTpass::SMTsolve_simple(SMT_expr expr) {
+int SMTpass::SMTsolve_simple(SMT_expr expr, SMTQueryKind kind) {
 	std::set<std::string> true_booleans;
-	return man->SMT_check(expr, true_booleans);
+	return SMT_check(expr, true_booleans, kind);
 }
 
 void SMTpass::visitReturnInst (ReturnInst &I) {
@@ -885,7 +1257,7 @@ void SMTpass::visitBranchInst (BranchInst &I) {
 	SMT_expr eexpr = man->SMT_mk_expr_from_bool_var(evar);
 
 	if (I.isUnconditional() || s == I.getSuccessor(1)) {
-		rho_components.push_back(man->SMT_mk_eq(eexpr,bexpr));
+		addControlComponent(man->SMT_mk_eq(eexpr,bexpr));
 	} else {
 		SMT_expr components_and;
 		std::vector<SMT_expr> components;
@@ -896,7 +1268,7 @@ void SMTpass::visitBranchInst (BranchInst &I) {
 		if (!cond.is_empty())
 			components.push_back(cond);
 		components_and = man->SMT_mk_and(components);
-		rho_components.push_back(man->SMT_mk_eq(eexpr,components_and));
+		addControlComponent(man->SMT_mk_eq(eexpr,components_and));
 
 		components.clear();
 		cond = man->SMT_mk_not(cond);
@@ -908,7 +1280,7 @@ void SMTpass::visitBranchInst (BranchInst &I) {
 			components.push_back(cond);
 		components_and = man->SMT_mk_and(components);
 		components.clear();
-		rho_components.push_back(man->SMT_mk_eq(eexpr,components_and));
+		addControlComponent(man->SMT_mk_eq(eexpr,components_and));
 	}
 }
 
@@ -937,7 +1309,7 @@ void SMTpass::visitInvokeInst (InvokeInst &I) {
 	std::vector<SMT_expr> components;
 	components.push_back(bexpr);
 	components.push_back(cexpr);
-	rho_components.push_back(man->SMT_mk_eq(eexpr,man->SMT_mk_and(components)));
+	addControlComponent(man->SMT_mk_eq(eexpr,man->SMT_mk_and(components)));
 
 	// Unwind destination
 	s = I.getUnwindDest();
@@ -945,7 +1317,7 @@ void SMTpass::visitInvokeInst (InvokeInst &I) {
 	eexpr = man->SMT_mk_expr_from_bool_var(evar);
 	components.pop_back();
 	components.push_back(man->SMT_mk_not(cexpr));
-	rho_components.push_back(man->SMT_mk_eq(eexpr,man->SMT_mk_and(components)));
+	addControlComponent(man->SMT_mk_eq(eexpr,man->SMT_mk_and(components)));
 }
 
 void SMTpass::visitUnreachableInst (UnreachableInst &I) {
@@ -6,6 +6,7 @@
 #ifndef SMT_H
 #define SMT_H
 
+#include <cstdint>
 #include <map>
 #include <vector>
 #include <list>
@@ -25,6 +26,16 @@
 #include "Node.h"
 #include "AbstractDisj.h"
 #include "SMT_manager.h"
+#include "SMTcapture.h"
+
+/**
+ * \brief kinds of SMT queries, which get different time budgets (see
+ * SMTpass::SMT_check)
+ */
+enum SMTQueryKind {
+	PATH_QUERY, // formulae of createSMTformula and createCheckFormula
+	INCLUSION_QUERY // comparisons of abstract values
+};
 
 /**
  * \class SMTpass
@@ -47,22 +58,120 @@ class SMTpass : private llvm::InstVisitor<SMTpass> {
 
 		int stack_level;
 
+		/**
+		 * \brief records the queries if --smt-capture is given, NULL
+		 * otherwise
+		 */
+		SMTcapture * capture;
+
+		/**
+		 * \brief calls the SMT_check of the manager, and records the query
+		 */
+		int check_once(SMT_expr expr, std::set<std::string> & true_booleans);
+
+		/**
+		 * \brief checks expr with the budgets of its kind of query: the
+		 * first budget is tried, then the next ones while the answer is
+		 * unknown. The last budget is the limit of --timeout, so that the
+		 * final answer is the one of a single check.
+		 *
+		 * A path query whose source needed a larger budget the last time,
+		 * possibly with another technique or stage, directly starts with
+		 * this budget: a source that stayed unknown only gets the last one.
+		 * The final check of a query is thus always made with the last
+		 * budget. The inclusion queries cannot be told apart, they always
+		 * start with the first budget.
+		 */
+		int SMT_check(
+				SMT_expr expr,
+				std::set<std::string> & true_booleans,
+				SMTQueryKind kind);
+
+		/**
+		 * \brief time budgets of each kind of query, in milliseconds, 0
+		 * being the limit of --timeout
+		 */
+		std::vector<unsigned> budgets[2];
+
+		/**
+		 * \brief source block of the formula built by the last call to
+		 * createSMTformula, or check of createCheckFormula, NULL once it is
+		 * checked
+		 */
+		llvm::Value * query_source;
+
+		/**
+		 * \brief for each source of path query, the index of the budget of
+		 * its last check. It is shared by the instances, and kept by
+		 * releaseMemory, so that the other techniques and stages analyzing
+		 * the function use it.
+		 */
+		static std::map<llvm::Value*,unsigned> query_levels;
+
 		/**
 		 * \brief stores the rho formula associated to each function
 		 */
 		std::map<llvm::Function*,SMT_expr> rho;
 
+		/**
+		 * \brief with --rho-slices, the constraints of rho on the
+		 * reachability of the blocks and edges are split in one part per
+		 * block of Pr, computed by computeRhoRec. Each part is guarded by
+		 * the activation literal rho_guard[dest]. The definitions of the
+		 * values are not guarded.
+		 */
+		std::map<llvm::BasicBlock*,SMT_expr> rho_guard;
+
+		/**
+		 * \brief block of Pr whose part of rho contains the encoding of
+		 * the basicblock
+		 */
+		std::map<llvm::BasicBlock*,llvm::BasicBlock*> rho_owner;
+
+		/**
+		 * \brief cache for getRhoSlice
+		 */
+		std::map<llvm::BasicBlock*,SMT_expr> rho_slice;
+
 		/**
 		 * \brief stores the already computed varnames, since the computation of
 		 * VarNames seems costly
 		 */
 		static std::map<llvm::Value*,std::string> VarNames;
 
+		/**
+		 * \brief small direct-mapped cache of the numerals built by
+		 * scalarToSmt, indexed by the value. It is emptied when the solver
+		 * context is reset, since the terms belong to it.
+		 */
+		struct numeral_cache_entry {
+			bool valid;
+			bool integer;
+			int64_t n;
+			SMT_expr expr;
+		};
+		static const unsigned numeral_cache_size = 64;
+		numeral_cache_entry numeral_cache[numeral_cache_size];
+
+		/**
+		 * \brief numeral n, of type Int if integer, Real otherwise
+		 */
+		SMT_expr numeralToSmt(int64_t n, bool integer);
+		void clear_numeral_cache();
+
 		/**
 		 * \brief when constructing rho, we use this vector
 		 */
 		std::vector<SMT_expr> rho_components;
 
+		/**
+		 * \brief with --rho-slices, constraints of rho on the reachability
+		 * of the blocks and edges, which are guarded by the activation
+		 * literals. Otherwise they go to rho_components.
+		 */
+		std::vector<SMT_expr> rho_control;
+		void addControlComponent(SMT_expr e);
+
 		/**
 		 * \brief when constructing instruction-related SMT formula, we
 		 * use this vector
@@ -78,6 +187,8 @@ class SMTpass : private llvm::InstVisitor<SMTpass> {
 		static const std::string getDisjunctiveIndexName(AbstractDisj * A, int index);
 		static const std::string getUndeterministicChoiceName(llvm::Value * v);
 		static const std::string getValueName(llvm::Value * v, bool primed);
+		static const std::string getRhoGuardName(llvm::BasicBlock * b);
+		static const std::string getSourceCounterName(llvm::BasicBlock * b);
 		/**
 		 * \}
 		 */
@@ -143,6 +254,30 @@ class SMTpass : private llvm::InstVisitor<SMTpass> {
 		void computeRho(llvm::Function &F);
 		void computePrSuccAndPred(llvm::Function &F);
 
+		/**
+		 * \brief formula stating that at most one source node bs_* of Pr is
+		 * true
+		 *
+		 * sequential counter encoding, linear in the size of Pr: o_X is
+		 * true iff the source node of X or of a block before X is true.
+		 * Since this formula is part of rho, a query only has to assert the
+		 * source node it starts from.
+		 */
+		SMT_expr computeAtMostOneSource(llvm::Function &F);
+
+		/**
+		 * \brief formula enabling the parts of rho needed by the paths
+		 * starting at source
+		 *
+		 * The parts of the blocks reachable from source without crossing
+		 * another block of Pr are enabled. The edges entering these blocks
+		 * from outside are set to false, as implied by the whole rho, since
+		 * their sources are not reachable. The definitions of the values are
+		 * never disabled, so that the values live at source and defined
+		 * outside the region keep their definition.
+		 */
+		SMT_expr getRhoSlice(llvm::BasicBlock * source);
+
 	public:
 		static char ID;
 
@@ -199,6 +334,32 @@ class SMTpass : private llvm::InstVisitor<SMTpass> {
 			params t,
 			SMT_expr constraint);
 
+		/**
+		 * \brief splits the paths starting at source into sub-cubes
+		 *
+		 * The literals are the edges towards the first successor of the
+		 * first k branching blocks met in depth-first order from source,
+		 * without crossing another block of Pr. Each of the 2^k cubes
+		 * fixes their polarity, so that the cubes cover all the paths.
+		 * With k = 0, or without any branch, the only cube is true.
+		 */
+		std::vector<SMT_expr> createPathCubes(llvm::BasicBlock * source, unsigned k);
+
+		/**
+		 * \brief computes the formula saying that the path starts from a
+		 * block of Pr of F, in a state of its invariant X_s[t]
+		 *
+		 * Unlike createSMTformula, the formula does not depend on the
+		 * source, so that it can be asserted once for all the checks of F.
+		 */
+		SMT_expr createInvariantsFormula(llvm::Function * F, params t);
+
+		/**
+		 * \brief computes the formula saying that the check is reached and
+		 * fails, see ExtractChecks
+		 */
+		SMT_expr createCheckFormula(llvm::CallInst * check);
+
 		/**
 		 * \brief solve the SMT expression expr
 		 * \return return true iff expr is
@@ -229,7 +390,7 @@ class SMTpass : private llvm::InstVisitor<SMTpass> {
 		 * \brief solve the SMT expression
 		 * \return 1 if satisfiable, 0 if not, -1 if unknown
 		 */
-		int SMTsolve_simple(SMT_expr expr);
+		int SMTsolve_simple(SMT_expr expr, SMTQueryKind kind = INCLUSION_QUERY);
 
 		/**
 		 * \brief gets the name of the node associated to a specific basicblock
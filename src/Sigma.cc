@@ -16,6 +16,7 @@
 #include "Pr.h"
 #include "SMTpass.h"
 #include "Debug.h"
+#include "MemStats.h"
 
 //#define DUMP_ADD
 
@@ -36,6 +37,7 @@ void Sigma::createADDVars(BasicBlock * Start, const std::set<BasicBlock*> & Pr,
 
 void Sigma::init(BasicBlock * Start) {
 	mgr = new Cudd(0,0);
+	MemStats::addCudd(mgr);
 	AddIndex = 0;
 	background = mgr->addZero().getNode();
 	zero = mgr->addZero().getNode();
@@ -59,6 +61,7 @@ Sigma::~Sigma() {
 	for (auto & entry : Add) {
 		delete entry.second;
 	}
+	MemStats::removeCudd(mgr);
 	delete mgr;
 }
 
@@ -94,6 +97,7 @@ void Sigma::insert(const std::list<BasicBlock*> & path, int start) {
 	if (!Add.count(start))
 		Add[start] = new ADD(mgr->addZero());
 	*Add[start] = *Add[start] + f;
+	Cache.clear();
 }
 
 void Sigma::remove(const std::list<BasicBlock*> & path, int start) {
@@ -101,12 +105,14 @@ void Sigma::remove(const std::list<BasicBlock*> & path, int start) {
 	if (!Add.count(start))
 		Add[start] = new ADD(mgr->addZero());
 	*Add[start] = *Add[start] * ~f;
+	Cache.clear();
 }
 
 void Sigma::clear() {
 	for (auto & entry : Add) {
 		*entry.second = mgr->addZero();
 	}
+	Cache.clear();
 }
 
 ADD Sigma::computef(const std::list<BasicBlock*> & path) {
@@ -192,6 +198,12 @@ int Sigma::getSigma(
 
 	int res = -1;
 
+	std::map<std::list<BasicBlock*>, int> & cache = Cache[start];
+	std::map<std::list<BasicBlock*>, int>::iterator it = cache.find(path);
+	if (it != cache.end()) {
+		return it->second - 1;
+	}
+
 	res = getActualValue(path, start);
 	if (res != -1) {
 		DEBUG(
@@ -201,16 +213,15 @@ int Sigma::getSigma(
 
 		AbstractDisj * D  = dynamic_cast<AbstractDisj*>(Nodes[path.back()]->X_d[pass->passID]);
 		// we iterate on the already existing abstract values of the disjunct
-		int index = 0;
-		for (Abstract * abs : D->disj) {
-			if (Xtemp->CanJoinPrecisely(D->man_disj, abs)) {
+		int N = D->disj.size();
+		for (int index = 0; index < N; index++) {
+			if (Xtemp->CanJoinPrecisely(D->man_disj, D->disj[index])) {
 				res = index + 1;
 				break;
 			}
 		}
 		if (res == -1) {
 			// there is no abstract value that fits well
-			int N = D->disj.size();
 			if (N < Max_Disj)
 				res = N+1;
 			else
@@ -229,6 +240,10 @@ int Sigma::getSigma(
 	*Out << "ADD IS "<< filename.str() << "\n";
 	DumpDotADD(*Add[start],filename.str());
 #endif
+	// the paths of a source are only cached up to SIGMA_CACHE_SIZE
+	if (cache.size() >= SIGMA_CACHE_SIZE)
+		cache.clear();
+	cache[path] = res;
 	return res -1;
 }
 
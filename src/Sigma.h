@@ -15,6 +15,11 @@
 #include "cuddObj.hh"
 #include "end_3rdparty.h"
 
+/**
+ * \brief maximum number of paths whose sigma value is cached, per source
+ */
+#define SIGMA_CACHE_SIZE 4096
+
 /**
  * \class Sigma
  * \brief class used by AIdis for computing the sigma function
@@ -81,6 +86,16 @@ class Sigma {
 		 */
 		std::map<int, ADD*> Add;
 
+		/**
+		 * \brief values of sigma already read or assigned in the ADD, indexed
+		 * by start, then by path
+		 *
+		 * avoids recomputing the ADD of the path at each call of getSigma.
+		 * The cache of a source is emptied when it reaches SIGMA_CACHE_SIZE
+		 * paths.
+		 */
+		std::map<int, std::map<std::list<llvm::BasicBlock*>, int> > Cache;
+
 		/**
 		 * \brief insert a path in the Bdd
 		 */
@@ -123,6 +138,16 @@ class Sigma {
 		 */
 		void clear();
 
+		/**
+		 * \brief index of the disjunct of the destination of path in which
+		 * Xtemp, the value computed along path from the disjunct start, is
+		 * joined
+		 *
+		 * The disjuncts are tried in their order with CanJoinPrecisely, and
+		 * the first one that can be joined precisely is chosen. No
+		 * candidate is pruned before this test: a bounding box cannot prove
+		 * that a join over the integers is imprecise.
+		 */
 		int getSigma(
 			std::list<llvm::BasicBlock*> & path,
 			int start,
@@ -0,0 +1,183 @@
+/**
+ * \file Stages.cc
+ * \brief Implementation of the Stages pass
+ * \author agent
+ */
+#include "Stages.h"
+#include "Pr.h"
+#include "SMTpass.h"
+#include "Compare.h"
+#include "AIpf.h"
+#include "AIpf_incr.h"
+#include "AIopt.h"
+#include "AIopt_incr.h"
+#include "AIGopan.h"
+#include "AIGuided.h"
+#include "AIClassic.h"
+
+using namespace llvm;
+
+char Stages::ID = 0;
+static RegisterPass<Stages>
+X("stages", "Staged analysis report", false, true);
+
+params Stages::getStageParams(int i) {
+	params P;
+	P.T = getTechnique();
+	P.D = getStageDomain(i);
+	P.N = useNewNarrowing();
+	P.TH = useThreshold();
+	return P;
+}
+
+template<int i>
+static ModulePass * createStagePass_T(Techniques T) {
+	switch (T) {
+		case LOOKAHEAD_WIDENING:
+			return new StagePassWrapper<AIGopan, i>();
+		case GUIDED:
+			return new StagePassWrapper<AIGuided, i>();
+		case PATH_FOCUSING:
+			return new StagePassWrapper<AIpf, i>();
+		case PATH_FOCUSING_INCR:
+			return new StagePassWrapper<AIpf_incr, i>();
+		case LW_WITH_PF:
+			return new StagePassWrapper<AIopt, i>();
+		case COMBINED_INCR:
+			return new StagePassWrapper<AIopt_incr, i>();
+		case SIMPLE:
+			return new StagePassWrapper<AIClassic, i>();
+		default:
+			// disjunctive invariants cannot be given to the next stage
+			return NULL;
+	}
+}
+
+ModulePass * Stages::createStagePass(Techniques T, int i) {
+	switch (i) {
+		case 0:
+			return createStagePass_T<0>(T);
+		case 1:
+			return createStagePass_T<1>(T);
+		case 2:
+			return createStagePass_T<2>(T);
+		case 3:
+			return createStagePass_T<3>(T);
+		default:
+			return NULL;
+	}
+}
+
+const char * Stages::getPassName() const {
+	return "Stages";
+}
+
+void Stages::getAnalysisUsage(AnalysisUsage &AU) const {
+	AU.setPreservesAll();
+}
+
+void Stages::CountNumberOfWarnings(params P, Function * F) {
+	Pr * FPr = Pr::getInstance(F);
+	for (Function::iterator i = F->begin(); i != F->end(); ++i) {
+		BasicBlock * b = i;
+		Abstract * X = Nodes[b]->X_s[P];
+		if (X == NULL) continue;
+		if (FPr->getAssert().count(b) || FPr->getUndefinedBehaviour().count(b)) {
+			if (!X->is_bottom())
+				Warnings[P]++;
+			else
+				Safe_properties[P]++;
+		}
+	}
+	// checks discharged after the analysis
+	Warnings[P] += ub_checks[P][F] - ub_checks_proved[P][F];
+	Safe_properties[P] += ub_checks_proved[P][F];
+}
+
+bool Stages::runOnModule(Module &M) {
+	SMTpass * LSMT = SMTpass::getInstance();
+	int nstages = getNumStages();
+
+	// comparison of each stage with the previous one, at the widening points
+	std::vector<CmpResults> results(nstages);
+
+	for (Module::iterator mIt = M.begin(); mIt != M.end(); ++mIt) {
+		LSMT->reset_SMTcontext();
+		Function * F = mIt;
+
+		// if the function is only a declaration, do nothing
+		if (F->begin() == F->end()) continue;
+		if (definedMain() && !isMain(F)) continue;
+		if (ignored(F)) continue;
+
+		for (int i = 0; i < nstages; i++) {
+			params P = getStageParams(i);
+			Time[P] += Total_time[P][F];
+			Time_SMT[P] += Total_time_SMT[P][F];
+			CountNumberOfWarnings(P,F);
+			if (i == 0) continue;
+
+			params Prev = getStageParams(i-1);
+			for (Function::iterator it = F->begin(); it != F->end(); ++it) {
+				BasicBlock * b = it;
+				if (!Pr::getInstance(F)->getPw().count(b)) continue;
+				Node * n = Nodes[b];
+				switch (Compare::compareAbstract(LSMT,n->X_s[Prev],n->X_s[P])) {
+					case 0:
+						results[i].eq++;
+						break;
+					case 1:
+						results[i].lt++;
+						break;
+					case -1:
+						results[i].gt++;
+						break;
+					case -2:
+						results[i].un++;
+						break;
+					default:
+						break;
+				}
+			}
+		}
+	}
+
+	changeColor(raw_ostream::BLUE);
+	*Out << "\n\n\n"
+			<< "---------------------------------\n"
+			<< "-         STAGED ANALYSIS       -\n"
+			<< "---------------------------------\n";
+	resetColor();
+
+	*Out << "\nTECHNIQUE:\n";
+	*Out << TechniquesToString(getTechnique());
+	*Out << "\nTECHNIQUE_END\n";
+
+	// time, SMT time, functions taken from the previous stage, warnings and
+	// safe properties of each stage
+	*Out << "\nSTAGES:\n";
+	for (int i = 0; i < nstages; i++) {
+		params P = getStageParams(i);
+		*Out << Time[P].count()
+			<< " " << Time_SMT[P].count()
+			<< " " << stage_skipped[P].size()
+			<< " " << Warnings[P]
+			<< " " << Safe_properties[P]
+			<< " // " << ApronManagerToString(P.D) << "\n";
+	}
+	*Out << "STAGES_END\n";
+
+	// number of widening points where the stage is equal to the previous one,
+	// more precise, less precise, not comparable
+	*Out << "\nPRECISION:\n";
+	for (int i = 1; i < nstages; i++) {
+		*Out << results[i].eq
+			<< " " << results[i].gt
+			<< " " << results[i].lt
+			<< " " << results[i].un
+			<< " // " << ApronManagerToString(getStageDomain(i-1))
+			<< " - " << ApronManagerToString(getStageDomain(i)) << "\n";
+	}
+	*Out << "PRECISION_END\n";
+	return true;
+}
@@ -0,0 +1,87 @@
+/**
+ * \file Stages.h
+ * \brief Declaration of the Stages pass and the StagePassWrapper template
+ * class
+ * \author agent
+ */
+#ifndef STAGES_H
+#define STAGES_H
+
+#include <map>
+
+#include "begin_3rdparty.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "end_3rdparty.h"
+
+#include "Analyzer.h"
+#include "Node.h"
+#include "Debug.h"
+
+/**
+ * \brief Wrapper that instantiates the pass P as the stage i of --stages
+ *
+ * Works like ModulePassWrapper, but the abstract domain is the one of the
+ * stage, and the pass uses the invariants computed by the stage i-1.
+ */
+template<typename P, int i>
+class StagePassWrapper : public P {
+	public:
+		static char ID;
+
+		StagePassWrapper()
+			: P(ID,getStageDomain(i),useNewNarrowing(),useThreshold())
+			{
+				this->setStage(i);
+			}
+
+		~StagePassWrapper() {}
+};
+
+template<typename P, int i>
+char StagePassWrapper<P, i>::ID = i;
+
+/**
+ * \class Stages
+ * \brief prints the time and the precision of each stage of --stages
+ *
+ * This pass has to be added after the passes of all the stages.
+ */
+class Stages : public llvm::ModulePass {
+
+	private:
+		std::map<params, Duration> Time;
+		std::map<params, Duration> Time_SMT;
+
+		// count the number of warnings emitted by each stage
+		std::map<params, int> Warnings;
+		// count the number of safe properties emitted by each stage
+		std::map<params, int> Safe_properties;
+
+		void CountNumberOfWarnings(params P, llvm::Function * F);
+
+	public:
+		static char ID;
+
+		Stages() : llvm::ModulePass(ID) {}
+
+		~Stages() {}
+
+		/**
+		 * \brief parameters of the stage i
+		 */
+		static params getStageParams(int i);
+
+		/**
+		 * \brief creates the pass that runs the technique T for the stage i
+		 */
+		static llvm::ModulePass * createStagePass(Techniques T, int i);
+
+		void getAnalysisUsage(llvm::AnalysisUsage &AU) const;
+
+		const char * getPassName() const;
+
+		bool runOnModule(llvm::Module &M);
+};
+
+#endif
@@ -0,0 +1,148 @@
+/**
+ * \file Trace.cc
+ * \brief Implementation of the Trace and TraceSpan classes
+ * \author agent
+ */
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+#include "Trace.h"
+#include "Analyzer.h"
+#include "utilities.h"
+
+using namespace llvm;
+
+bool Trace::enabled = false;
+TimePoint Trace::origin;
+
+/**
+ * \brief spans recorded by a thread and not written yet
+ */
+struct TraceBuffer {
+	unsigned tid;
+	std::vector<TraceEvent> events;
+};
+
+/**
+ * \brief buffers of all the threads, appended when a thread records its
+ * first span. trace_mutex protects the list and the file.
+ */
+static std::vector<TraceBuffer *> buffers;
+static std::ofstream * trace_file = NULL;
+static bool first_event = true;
+static std::mutex trace_mutex;
+
+TraceBuffer * Trace::buffer() {
+	static thread_local TraceBuffer * b = NULL;
+	if (b == NULL) {
+		b = new TraceBuffer();
+		b->events.reserve(TRACE_BUFFER_SIZE);
+		std::lock_guard<std::mutex> lock(trace_mutex);
+		b->tid = buffers.size() + 1;
+		buffers.push_back(b);
+	}
+	return b;
+}
+
+bool Trace::start(const std::string & filename) {
+	trace_file = new std::ofstream(filename.c_str());
+	if (!trace_file->is_open()) {
+		*Out << "ERROR: cannot open the trace file " << filename << "\n";
+		delete trace_file;
+		trace_file = NULL;
+		return false;
+	}
+	*trace_file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	origin = time_now();
+	enabled = true;
+	return true;
+}
+
+void Trace::record(const TraceEvent & e) {
+	TraceBuffer * b = buffer();
+	b->events.push_back(e);
+	if (b->events.size() >= TRACE_BUFFER_SIZE)
+		flush(b);
+}
+
+static std::string block_name(BasicBlock * b) {
+	if (b->hasName()) return b->getName();
+	std::ostringstream name;
+	name << b;
+	return name.str();
+}
+
+void Trace::flush(TraceBuffer * b) {
+	std::lock_guard<std::mutex> lock(trace_mutex);
+	std::ofstream & out = *trace_file;
+	for (const TraceEvent & e : b->events) {
+		if (!first_event) out << ",\n";
+		first_event = false;
+		out << "{\"name\":\"" << e.name << "\",\"cat\":\"pagai\",\"ph\":\"X\""
+			<< ",\"pid\":1,\"tid\":" << b->tid
+			<< ",\"ts\":" << std::fixed << Duration(e.start - origin).count() * 1e6
+			<< ",\"dur\":" << e.duration.count() * 1e6
+			<< ",\"args\":{";
+		if (e.F != NULL)
+			out << "\"function\":\"" << utilities::json_escape(e.F->getName()) << "\"";
+		if (e.bb != NULL)
+			out << ",\"block\":\"" << utilities::json_escape(block_name(e.bb)) << "\"";
+		if (e.technique >= 0)
+			out << (e.F != NULL ? "," : "") << "\"technique\":\""
+				<< TechniquesToString((Techniques)e.technique) << "\"";
+		out << "}}";
+	}
+	b->events.clear();
+}
+
+void Trace::finish() {
+	if (!enabled) return;
+	enabled = false;
+	std::vector<TraceBuffer *> all;
+	{
+		std::lock_guard<std::mutex> lock(trace_mutex);
+		all = buffers;
+	}
+	for (TraceBuffer * b : all)
+		flush(b);
+	*trace_file << "\n]}\n";
+	delete trace_file;
+	trace_file = NULL;
+}
+
+TraceSpan::TraceSpan(const char * name, BasicBlock * bb, params P) {
+	e.name = NULL;
+	if (!Trace::isEnabled()) return;
+	e.name = name;
+	e.F = bb->getParent();
+	e.bb = bb;
+	e.technique = P.T;
+	e.start = time_now();
+}
+
+TraceSpan::TraceSpan(const char * name, Function * F, params P) {
+	e.name = NULL;
+	if (!Trace::isEnabled()) return;
+	e.name = name;
+	e.F = F;
+	e.bb = NULL;
+	e.technique = P.T;
+	e.start = time_now();
+}
+
+TraceSpan::TraceSpan(const char * name, Function * F) {
+	e.name = NULL;
+	if (!Trace::isEnabled()) return;
+	e.name = name;
+	e.F = F;
+	e.bb = NULL;
+	e.technique = -1;
+	e.start = time_now();
+}
+
+TraceSpan::~TraceSpan() {
+	if (e.name == NULL) return;
+	e.duration = time_now() - e.start;
+	Trace::record(e);
+}
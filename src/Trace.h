@@ -0,0 +1,103 @@
+/**
+ * \file Trace.h
+ * \brief Declaration of the Trace and TraceSpan classes
+ * \author agent
+ */
+#ifndef _TRACE_H
+#define _TRACE_H
+
+#include <string>
+#include <vector>
+
+#include "begin_3rdparty.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/BasicBlock.h"
+#include "end_3rdparty.h"
+
+#include "Node.h"
+#include "Debug.h"
+
+/**
+ * \brief a span of the timeline
+ */
+struct TraceEvent {
+	const char * name;
+	llvm::Function * F;
+	llvm::BasicBlock * bb;
+	// technique of the pass, -1 if unknown
+	int technique;
+	TimePoint start;
+	Duration duration;
+};
+
+/**
+ * \brief number of spans a thread keeps in its buffer before writing them
+ * into the trace file
+ */
+#define TRACE_BUFFER_SIZE 4096
+
+struct TraceBuffer;
+
+/**
+ * \class Trace
+ * \brief timeline of the analysis, written in the Chrome trace-event format
+ * with --trace
+ *
+ * Each thread records its spans into its own buffer, without any lock. A
+ * buffer is written into the file, under a lock, when it holds
+ * TRACE_BUFFER_SIZE spans, so that the memory used by the trace stays
+ * bounded on long analyses. The names of the functions and blocks are only
+ * computed when the buffer is written.
+ */
+class Trace {
+
+	private:
+		static bool enabled;
+		static TimePoint origin;
+
+		/**
+		 * \brief buffer of the calling thread, created on its first span
+		 */
+		static TraceBuffer * buffer();
+
+		/**
+		 * \brief writes the spans of b into the file, and empties b
+		 */
+		static void flush(TraceBuffer * b);
+
+	public:
+		/**
+		 * \brief opens filename and starts recording the spans
+		 * \return false if the file cannot be written
+		 */
+		static bool start(const std::string & filename);
+
+		static bool isEnabled() {return enabled;}
+
+		static void record(const TraceEvent & e);
+
+		/**
+		 * \brief writes the spans still in the buffers of all the threads,
+		 * and closes the file
+		 */
+		static void finish();
+};
+
+/**
+ * \class TraceSpan
+ * \brief records a span from its construction to its destruction, if the
+ * trace is enabled
+ */
+class TraceSpan {
+
+	private:
+		TraceEvent e;
+
+	public:
+		TraceSpan(const char * name, llvm::BasicBlock * bb, params P);
+		TraceSpan(const char * name, llvm::Function * F, params P);
+		TraceSpan(const char * name, llvm::Function * F);
+		~TraceSpan();
+};
+
+#endif
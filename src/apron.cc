@@ -3,6 +3,7 @@
  * \brief Implementation of Apron interface
  * \author Julien Henry
  */
+#include <limits>
 #include <stdio.h>
 #include <string>
 
@@ -61,7 +62,11 @@ char* ap_var_to_string(ap_var_t var) {
 	} else {
 		Value * val = dyn_cast<Value>((Value*)var);
 
-		if (useSourceName()) {
+		const NameIndex * index;
+		if (useSourceName() && (index = recoverName::getNameIndex(val)) != NULL) {
+			const SourceName * SN = index->find(val);
+			name = (SN != NULL) ? SN->name : SMTpass::getVarName(val);
+		} else if (useSourceName()) {
 			const Value * val1=val;
 			Info IN = recoverName::getMDInfos(val1);
 			if(!IN.empty()) {
@@ -116,6 +121,22 @@ void init_apron() {
 	ap_var_operations = &var_op_manager;
 }
 
+double scalar_to_double_down(ap_scalar_t * s) {
+	int inf = ap_scalar_infty(s);
+	if (inf) return inf * std::numeric_limits<double>::infinity();
+	double d;
+	ap_double_set_scalar(&d, s, GMP_RNDD);
+	return d;
+}
+
+double scalar_to_double_up(ap_scalar_t * s) {
+	int inf = ap_scalar_infty(s);
+	if (inf) return inf * std::numeric_limits<double>::infinity();
+	double d;
+	ap_double_set_scalar(&d, s, GMP_RNDU);
+	return d;
+}
+
 ap_manager_t * create_manager(Apron_Manager_Type man) {
 	ap_manager_t * ap_man;
 	(void) ap_man; // disable unused warning if no PPL
@@ -132,6 +153,8 @@ ap_manager_t * create_manager(Apron_Manager_Type man) {
 			return pk_manager_alloc(true); // NewPolka strict polyhedra
 		case PKEQ:
 			return pkeq_manager_alloc(); // NewPolka linear equalities
+		case NATIVE_BOX:
+			return box_manager_alloc(); // Apron boxes, for the operations not done by AbstractInterval
 #ifdef PPL_ENABLED
 		case PPL_POLY:
 			return ap_ppl_poly_manager_alloc(true); // PPL strict polyhedra
@@ -28,6 +28,13 @@ ap_manager_t * create_manager(Apron_Manager_Type man);
 
 char* ap_var_to_string(ap_var_t var);
 
+/**
+ * \brief double approximation of s from below (resp. above), infinite
+ * scalars give -inf or +inf
+ */
+double scalar_to_double_down(ap_scalar_t * s);
+double scalar_to_double_up(ap_scalar_t * s);
+
 
 llvm::raw_ostream& operator<<( llvm::raw_ostream &stream, ap_tcons1_t & cons);
 
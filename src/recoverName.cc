@@ -5,6 +5,7 @@
  */
 #include <algorithm>
 #include <fstream>
+#include <mutex>
 
 #include "config.h"
 
@@ -37,10 +38,19 @@ std::map<BasicBlock*,int> Block_line,Block_column;
 
 std::map<Value*,Info> computed_mappings;
 
+// llvm.dbg.value instructions of each block, filled by pass1
+static std::map<BasicBlock*, std::vector<const DbgValueInst*> > block_dbg_values;
+
+// indexes of the processed functions; they are never freed, so that the
+// threads can keep a pointer to them
+static std::map<const Function*, const NameIndex*> name_indexes;
+static std::mutex name_indexes_mutex;
+
 void recoverName::fill_info_set(BasicBlock * b, std::set<Info> & infos, Value * val, std::set<BasicBlock*> & seen) {
 	seen.insert(b);
-	for (BasicBlock::iterator I = b->begin(); I != b->end(); ++I) {
-		if (const DbgValueInst *DVI=dyn_cast<DbgValueInst>(I)) {
+	auto dbg = block_dbg_values.find(b);
+	if (dbg != block_dbg_values.end()) {
+		for (const DbgValueInst * DVI : dbg->second) {
 			if (DVI->getValue() == val) {
 				//*Out << "match found between " << *val << " " << *DVI->getValue() << "\n";
 				MDNode * MD = DVI->getVariable();
@@ -97,50 +107,44 @@ std::set<Info> recoverName::getMDInfos_rec(Value* v, std::set<Value*> & seen) {
 	return res_infos;
 }
 
-Info recoverName::getMDInfos(const Value* V) {
+bool recoverName::resolve(const Value * V, Info & res) {
 	Value * v = const_cast<Value*>(V);
-	if (computed_mappings.count(v)) return computed_mappings[v];
 
 	if (PHINode * phi = dyn_cast<PHINode>(v)) {
 		//*Out << "getMD " << *phi << "\n";
 		std::set<Value*> seen;
 		seen.insert(phi);
 		std::set<Info> s = getMDInfos_rec(v,seen);
-		if (s.empty()) {
-			computed_mappings[v] = Info(SMTpass::getVarName(v),-1,"unknown");
-		} else if (s.size() > 1) {
-			// there are several choices...
-			// we choose one depending on teh syntactic name of the LLVM
-			// variable
-			std::string syntactic_name = SMTpass::getVarName(v);
-			bool found = false;
-			for (const Info & info : s) {
-				if (info.getName().compare(syntactic_name)) {
-					computed_mappings[v] = info;
-					found = true;
-				}
-			}
-			if (!found) {
-				computed_mappings[v] = Info(SMTpass::getVarName(v),-1,"unknown");
+		if (s.size() == 1) {
+			res = *s.begin();
+			return true;
+		}
+		if (s.empty()) return false;
+		// there are several choices...
+		// we choose one depending on teh syntactic name of the LLVM
+		// variable
+		std::string syntactic_name = SMTpass::getVarName(v);
+		bool found = false;
+		for (const Info & info : s) {
+			if (info.getName().compare(syntactic_name)) {
+				res = info;
+				found = true;
 			}
-		} else {
-			computed_mappings[v] = *s.begin();
 		}
-		return computed_mappings[v];
+		return found;
 	}
 
 	auto range = M1.equal_range(V);
 	for (auto it = range.first; it != range.second; ++it) {
-		computed_mappings[v] = it->second;
 		if (isa<Argument>(v) && !it->second.IsArg()) continue;
 		if (isa<GlobalValue>(v) && !it->second.IsGlobal()) continue;
-		computed_mappings[v] = it->second;
 		DEBUG(
 			*Out << "for " << *V << " " ;
 			it->second.display();
 			*Out <<  "\n";
 		);
-		return it->second;
+		res = it->second;
+		return true;
 	}
 
 	std::set<const Value*> seen;
@@ -151,10 +155,92 @@ Info recoverName::getMDInfos(const Value* V) {
 		DEBUG(
 			*Out << "no possible mappings for " << *V << "\n...";
 		);
-		return Info(SMTpass::getVarName(v), -1, "unknown");
+		return false;
+	}
+	res = *possible_mappings.begin();
+	return true;
+}
+
+Info recoverName::getMDInfos(const Value* V) {
+	Value * v = const_cast<Value*>(V);
+	if (computed_mappings.count(v)) return computed_mappings[v];
+
+	Info res;
+	if (resolve(V, res)) {
+		computed_mappings[v] = res;
+		return res;
+	}
+	res = Info(SMTpass::getVarName(v), -1, "unknown");
+	if (isa<PHINode>(v)) computed_mappings[v] = res;
+	return res;
+}
+
+NameIndex::NameIndex(Function * F) {
+	std::vector<Value*> values;
+	for (Function::arg_iterator a = F->arg_begin(); a != F->arg_end(); ++a)
+		values.push_back(a);
+	for (inst_iterator i = inst_begin(F), e = inst_end(F); i != e; ++i)
+		values.push_back(&*i);
+
+	for (Value * v : values) {
+		// the other values have no source variable, see recoverName::resolve
+		if (!isa<PHINode>(v) && M1.count(v) == 0) continue;
+		Info info;
+		if (!recoverName::resolve(v, info) || info.empty()) continue;
+		SourceName SN;
+		SN.name = info.getName();
+		SN.line = info.getLineNo();
+		SN.column = -1;
+		if (Instruction * I = dyn_cast<Instruction>(v)) {
+			DebugLoc loc = I->getDebugLoc();
+			if (!loc.isUnknown()) {
+				SN.line = loc.getLine();
+				SN.column = loc.getCol();
+			}
+		}
+		table.push_back(std::make_pair(v, SN));
+	}
+	std::sort(table.begin(), table.end(),
+		[](const std::pair<const Value*, SourceName> & a, const std::pair<const Value*, SourceName> & b) {
+			return a.first < b.first;
+		});
+}
+
+const SourceName * NameIndex::find(const Value * V) const {
+	auto it = std::lower_bound(table.begin(), table.end(), V,
+		[](const std::pair<const Value*, SourceName> & a, const Value * v) {
+			return a.first < v;
+		});
+	if (it == table.end() || it->first != V) return NULL;
+	return &it->second;
+}
+
+const NameIndex * recoverName::getNameIndex(const Value * V) {
+	const Function * F;
+	if (const Instruction * I = dyn_cast<Instruction>(V)) {
+		F = I->getParent()->getParent();
+	} else if (const Argument * A = dyn_cast<Argument>(V)) {
+		F = A->getParent();
+	} else {
+		return NULL;
+	}
+
+	// the values printed by a thread mostly belong to the same function
+	static thread_local const Function * last_F = NULL;
+	static thread_local const NameIndex * last_index = NULL;
+	if (F == last_F) return last_index;
+
+	const NameIndex * index = NULL;
+	{
+		std::lock_guard<std::mutex> lock(name_indexes_mutex);
+		auto it = name_indexes.find(F);
+		if (it != name_indexes.end()) index = it->second;
+	}
+	if (index != NULL) {
+		last_F = F;
+		last_index = index;
 	}
-	computed_mappings[v] = Info(*possible_mappings.begin());
-	return Info(*possible_mappings.begin());
+	return index;
 }
 
 // for debugging purpose...
@@ -213,6 +299,10 @@ std::set<Info,compare_Info> recoverName::getPossibleMappings(const Value * V, st
 //process function involves calling two functions 'pass1' and then 'pass2', passing the argument Function*
 //pass1 and pass2 create maps M1 and M2 for all const Value* present in Function* passed to process function.
 int recoverName::process(Function *F) {
+	std::lock_guard<std::mutex> lock(name_indexes_mutex);
+	// the analysis passes do not modify the code, F is processed by the
+	// first of them only
+	if (name_indexes.count(F)) return 1;
 	pass1(F);
 	DEBUG(
 		*Out<<"MAPPING OF VARIABLES ...\nMap1\n";
@@ -222,6 +312,7 @@ int recoverName::process(Function *F) {
 			*Out<<"\n";
 		}
 	);
+	name_indexes[F] = new NameIndex(F);
 	return 1;
 }
 
@@ -307,6 +398,7 @@ void recoverName::pass1(Function *F) {
 			//now check if the instruction is of type llvm.dbg.value or llvm.dbg.declare
 			bool dbgInstFlag = false;
 			if (const DbgValueInst *DVI = dyn_cast<DbgValueInst>(I)) {
+				block_dbg_values[bb].push_back(DVI);
 				val = DVI->getValue();
 				MD = DVI->getVariable();
 				dbgInstFlag = true;
@@ -8,6 +8,9 @@
 
 #include <set>
 #include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "config.h"
 
@@ -40,11 +43,48 @@ class compare_Info
 		}
 };
 
+/**
+ * \brief name of a value in the source code, and position of its definition
+ */
+struct SourceName {
+	std::string name;
+	// position of the instruction defining the value, or line of the
+	// declaration of the source variable and column -1 if the instruction
+	// has no debug location
+	int line;
+	int column;
+};
+
+/**
+ * \class NameIndex
+ * \brief source names of the values of a function
+ *
+ * The index is built by recoverName::process, in one pass over the function.
+ * It is a table sorted by value that is never modified afterwards, so that
+ * it can be read by several threads without lock. A value of the function
+ * that is not in the table has no source name.
+ */
+class NameIndex {
+
+	private:
+		std::vector<std::pair<const llvm::Value*, SourceName> > table;
+
+	public:
+		NameIndex(llvm::Function * F);
+
+		/**
+		 * \brief source name of V, NULL if V has none
+		 */
+		const SourceName * find(const llvm::Value * V) const;
+};
+
 /**
  * \class recoverName
  * \brief recover the names of the variables from the source code
  */
 class recoverName {
+	friend class NameIndex;
+
 	private :
 		static void pass1(llvm::Function *F);
 
@@ -55,6 +95,12 @@ class recoverName {
 
 		static std::set<Info, compare_Info> getPossibleMappings(const llvm::Value * V, std::set<const llvm::Value *> & seen);
 
+		/**
+		 * \brief computes the source variable of V
+		 * \return false if V has no source variable
+		 */
+		static bool resolve(const llvm::Value * V, Info & res);
+
 		static void fill_info_set(
 				llvm::BasicBlock * b,
 				std::set<Info> & infos,
@@ -65,7 +111,18 @@ class recoverName {
 	public:
 		static std::set<Info> getMDInfos_rec(llvm::Value* v, std::set<llvm::Value*> & seen);
 		static Info getMDInfos(const llvm::Value* V);
+
+		/**
+		 * \brief computes the source names of the values of F, once for
+		 * all the passes
+		 */
 		static int process(llvm::Function* F);
+
+		/**
+		 * \brief index of the function of V, NULL if V is not an argument
+		 * or an instruction of a processed function
+		 */
+		static const NameIndex * getNameIndex(const llvm::Value * V);
 		static int getBasicBlockLineNo(llvm::BasicBlock* BB);
 		static int getBasicBlockColumnNo(llvm::BasicBlock* BB);
 		static std::string getSourceFileName(llvm::Function * F);
@@ -0,0 +1,517 @@
+/**
+ * \file microbench.cc
+ * \brief pagai-microbench: measures the primitives of the analysis in isolation
+ * \author agent
+ *
+ * The benchmarks run on a generated function: a loop over --vars integer
+ * variables, whose body is a sequence of --branches if-then-else. They
+ * measure the operations of the abstract values (for each Abstract class and
+ * each Apron domain), the translation of abstract values into SMT formulas
+ * (for each SMT backend), the path sets of PathTree_br, and the liveness and
+ * Environment computations.
+ *
+ * Each benchmark is run --runs times, and the tool reports the minimum,
+ * median and mean time of a run. The results can be written into a JSON file
+ * and compared with a previous one with scripts/compare_microbench.py.
+ */
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "begin_3rdparty.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+#include "ap_global1.h"
+#include "end_3rdparty.h"
+
+#include "../Analyzer.h"
+#include "../AbstractMan.h"
+#include "../Abstract.h"
+#include "../Constraint.h"
+#include "../Debug.h"
+#include "../Environment.h"
+#include "../Expr.h"
+#include "../Live.h"
+#include "../Node.h"
+#include "../PathTree_br.h"
+#include "../Pr.h"
+#include "../SMTpass.h"
+#include "../apron.h"
+
+namespace po = boost::program_options;
+using namespace llvm;
+
+/**
+ * \brief times of the runs of a benchmark, in nanoseconds
+ */
+struct Result {
+	std::string name;
+	std::vector<double> times;
+
+	double min() const {return *std::min_element(times.begin(), times.end());}
+
+	double median() const {
+		std::vector<double> t(times);
+		std::sort(t.begin(), t.end());
+		return t[t.size() / 2];
+	}
+
+	double mean() const {
+		double sum = 0;
+		for (double t : times) sum += t;
+		return sum / times.size();
+	}
+};
+
+static std::vector<Result> results;
+static unsigned runs;
+static std::string filter;
+
+/**
+ * \brief runs op the given number of times; setup and teardown are called
+ * before and after each run, and are not measured
+ */
+static void measure(
+		const std::string & name,
+		std::function<void()> setup,
+		std::function<void()> op,
+		std::function<void()> teardown) {
+	if (name.find(filter) == std::string::npos) return;
+	Result r;
+	r.name = name;
+	for (unsigned i = 0; i < runs; i++) {
+		setup();
+		TimePoint start = time_now();
+		op();
+		Duration d = time_now() - start;
+		teardown();
+		r.times.push_back(d.count() * 1e9);
+	}
+	std::cout << std::left << std::setw(56) << name << std::right
+		<< " min " << std::setw(10) << (long long)r.min()
+		<< " median " << std::setw(10) << (long long)r.median()
+		<< " mean " << std::setw(10) << (long long)r.mean() << " ns\n";
+	results.push_back(r);
+}
+
+static void nothing() {}
+
+/**
+ * \brief creates the function: a loop over nvars variables, whose body is a
+ * sequence of nbranches if-then-else updating one of the variables
+ */
+static Function * createFunction(Module * M, unsigned nvars, unsigned nbranches) {
+	LLVMContext & C = M->getContext();
+	Type * i32 = Type::getInt32Ty(C);
+	std::vector<Type*> args(nvars, i32);
+	Function * F = Function::Create(FunctionType::get(i32, args, false),
+			GlobalValue::ExternalLinkage, "bench", M);
+	BasicBlock * entry = BasicBlock::Create(C, "entry", F);
+	BasicBlock * header = BasicBlock::Create(C, "header", F);
+	BasicBlock * body = BasicBlock::Create(C, "body", F);
+	BasicBlock * exit = BasicBlock::Create(C, "exit", F);
+
+	IRBuilder<> B(entry);
+	B.CreateBr(header);
+
+	B.SetInsertPoint(header);
+	std::vector<PHINode*> phis;
+	std::vector<Value*> vars;
+	for (Function::arg_iterator a = F->arg_begin(); a != F->arg_end(); ++a) {
+		PHINode * phi = B.CreatePHI(i32, 2, "x");
+		phi->addIncoming(a, entry);
+		phis.push_back(phi);
+		vars.push_back(phi);
+	}
+	B.CreateCondBr(B.CreateICmpSLT(vars[0], B.getInt32(1000)), body, exit);
+
+	BasicBlock * current = body;
+	for (unsigned k = 0; k < nbranches; k++) {
+		unsigned v = k % nvars;
+		unsigned w = (k + 1) % nvars;
+		BasicBlock * then = BasicBlock::Create(C, "then", F);
+		BasicBlock * els = BasicBlock::Create(C, "else", F);
+		BasicBlock * join = BasicBlock::Create(C, "join", F);
+		B.SetInsertPoint(current);
+		B.CreateCondBr(B.CreateICmpSLT(vars[v], vars[w]), then, els);
+		B.SetInsertPoint(then);
+		Value * t = B.CreateAdd(vars[v], B.getInt32(k + 1));
+		B.CreateBr(join);
+		B.SetInsertPoint(els);
+		Value * e = B.CreateSub(vars[v], vars[w]);
+		B.CreateBr(join);
+		B.SetInsertPoint(join);
+		PHINode * phi = B.CreatePHI(i32, 2);
+		phi->addIncoming(t, then);
+		phi->addIncoming(e, els);
+		vars[v] = phi;
+		current = join;
+	}
+	B.SetInsertPoint(current);
+	B.CreateBr(header);
+	for (unsigned i = 0; i < nvars; i++)
+		phis[i]->addIncoming(vars[i], current);
+
+	B.SetInsertPoint(exit);
+	B.CreateRet(phis[0]);
+	return F;
+}
+
+/**
+ * \brief the paths from the loop header to itself, at most 2^max_branches
+ */
+static std::vector<std::list<BasicBlock*> > loopPaths(BasicBlock * header, unsigned max_branches) {
+	// each if-then-else of the body: the two branches and the join block
+	BasicBlock * body = header->getTerminator()->getSuccessor(0);
+	std::vector<BasicBlock*> then, els, join;
+	BasicBlock * b = body;
+	while (b->getTerminator()->getNumSuccessors() == 2) {
+		then.push_back(b->getTerminator()->getSuccessor(0));
+		els.push_back(b->getTerminator()->getSuccessor(1));
+		b = then.back()->getTerminator()->getSuccessor(0);
+		join.push_back(b);
+	}
+	unsigned nbranches = then.size();
+	unsigned npaths = 1u << std::min(nbranches, max_branches);
+
+	std::vector<std::list<BasicBlock*> > paths;
+	for (unsigned m = 0; m < npaths; m++) {
+		std::list<BasicBlock*> path;
+		path.push_back(header);
+		path.push_back(body);
+		for (unsigned k = 0; k < nbranches; k++) {
+			path.push_back(((m >> k) & 1) ? els[k] : then[k]);
+			path.push_back(join[k]);
+		}
+		path.push_back(header);
+		paths.push_back(path);
+	}
+	return paths;
+}
+
+/**
+ * \brief the expression x - y + c, y may be NULL
+ */
+static Expr * linearExpr(ap_var_t x, ap_var_t y, double c) {
+	Expr ex(x);
+	Expr ec(c);
+	Expr::common_environment(&ex, &ec);
+	Expr * res = new Expr(AP_TEXPR_ADD, &ex, &ec, AP_RTYPE_INT, AP_RDIR_RND);
+	if (y != NULL) {
+		Expr ey(y);
+		Expr::common_environment(res, &ey);
+		Expr * sub = new Expr(AP_TEXPR_SUB, res, &ey, AP_RTYPE_INT, AP_RDIR_RND);
+		delete res;
+		res = sub;
+	}
+	return res;
+}
+
+/**
+ * \brief the abstract value of the octagon c - i <= x_i <= 100 + c + i,
+ * x_i - x_{i+1} <= c + i
+ */
+static Abstract * createValue(AbstractMan * aman, ap_manager_t * man, Environment * env,
+		const std::vector<ap_var_t> & vars, double c) {
+	Abstract * A = aman->NewAbstract(man, env);
+	A->set_top(env);
+	Constraint_array cons;
+	for (unsigned i = 0; i < vars.size(); i++) {
+		Expr * lower = linearExpr(vars[i], NULL, -(c - i));
+		Expr * upper = linearExpr(vars[i], NULL, -(100 + c + i));
+		cons.add_constraint(new Constraint(AP_CONS_SUPEQ, lower, NULL));
+		// -(x_i - 100 - c - i) >= 0
+		Expr zero(0.);
+		Expr::common_environment(upper, &zero);
+		Expr neg(AP_TEXPR_SUB, &zero, upper, AP_RTYPE_INT, AP_RDIR_RND);
+		cons.add_constraint(new Constraint(AP_CONS_SUPEQ, &neg, NULL));
+		delete lower;
+		delete upper;
+		if (vars.size() > 1) {
+			// x_{i+1} - x_i + c + i >= 0
+			Expr * diff = linearExpr(vars[(i + 1) % vars.size()], vars[i], c + i);
+			cons.add_constraint(new Constraint(AP_CONS_SUPEQ, diff, NULL));
+			delete diff;
+		}
+	}
+	A->meet_tcons_array(&cons);
+	return A;
+}
+
+static void benchAbstract(const std::string & kind, AbstractMan * aman, Apron_Manager_Type D,
+		Environment * env, const std::vector<ap_var_t> & vars) {
+	ap_manager_t * man = create_manager(D);
+	std::string suffix = "/" + kind + "/" + ApronManagerToString(D);
+	Abstract * A = createValue(aman, man, env, vars, 0);
+	Abstract * B = createValue(aman, man, env, vars, 10);
+	Abstract * X = NULL;
+	std::vector<Abstract*> preds;
+	std::vector<ap_var_t> names;
+	std::vector<Expr*> exprs;
+	auto teardown = [&]() {delete X; X = NULL;};
+
+	measure("abstract/join" + suffix,
+		[&]() {
+			X = aman->NewAbstract(man, env);
+			preds.clear();
+			preds.push_back(aman->NewAbstract(A));
+			preds.push_back(aman->NewAbstract(B));
+		},
+		[&]() {X->join_array(env, preds);},
+		teardown);
+
+	measure("abstract/widening" + suffix,
+		[&]() {X = aman->NewAbstract(B);},
+		[&]() {X->widening(A);},
+		teardown);
+
+	measure("abstract/meet" + suffix,
+		[&]() {X = aman->NewAbstract(A);},
+		[&]() {X->meet(B);},
+		teardown);
+
+	measure("abstract/assign_texpr_array" + suffix,
+		[&]() {
+			X = aman->NewAbstract(A);
+			for (unsigned i = 0; i < vars.size(); i++) {
+				names.push_back(vars[i]);
+				exprs.push_back(linearExpr(vars[i], vars[(i + 1) % vars.size()], i + 1));
+			}
+		},
+		[&]() {X->assign_texpr_array(names, exprs, NULL);},
+		teardown);
+
+	delete A;
+	delete B;
+	ap_manager_free(man);
+}
+
+static void benchSMT(const std::string & kind, AbstractMan * aman, Apron_Manager_Type D,
+		const std::string & solver, Function * F, Environment * env, const std::vector<ap_var_t> & vars) {
+	ap_manager_t * man = create_manager(D);
+	std::string suffix = "/" + solver + "/" + kind + "/" + ApronManagerToString(D);
+	SMTpass * LSMT = SMTpass::getInstance();
+	Pr * FPr = Pr::getInstance(F);
+	BasicBlock * header = F->getEntryBlock().getTerminator()->getSuccessor(0);
+
+	params P;
+	P.T = LW_WITH_PF;
+	P.D = D;
+	P.N = false;
+	P.TH = false;
+	Environment empty_env;
+	for (BasicBlock * b : FPr->getPr()) {
+		if (b == header)
+			Nodes[b]->X_s[P] = createValue(aman, man, env, vars, 0);
+		else
+			Nodes[b]->X_s[P] = aman->NewAbstract(man, &empty_env);
+	}
+	Abstract * A = Nodes[header]->X_s[P];
+
+	measure("smt/AbstractToSmt" + suffix,
+		nothing,
+		[&]() {LSMT->AbstractToSmt(NULL, A);},
+		nothing);
+
+	measure("smt/createSMTformula" + suffix,
+		nothing,
+		[&]() {LSMT->createSMTformula(header, false, P, LSMT->man->SMT_mk_true());},
+		nothing);
+
+	for (BasicBlock * b : FPr->getPr()) {
+		delete Nodes[b]->X_s[P];
+		Nodes[b]->X_s.erase(P);
+	}
+	ap_manager_free(man);
+}
+
+static void benchPathTree(BasicBlock * header, unsigned max_branches) {
+	std::vector<std::list<BasicBlock*> > paths = loopPaths(header, max_branches);
+	PathTree_br * T = NULL;
+	auto teardown = [&]() {delete T; T = NULL;};
+
+	measure("pathtree/insert",
+		[&]() {T = new PathTree_br(header);},
+		[&]() {for (auto & p : paths) T->insert(p);},
+		teardown);
+
+	measure("pathtree/exist",
+		[&]() {
+			T = new PathTree_br(header);
+			for (auto & p : paths) T->insert(p);
+		},
+		[&]() {for (auto & p : paths) T->exist(p);},
+		teardown);
+
+	measure("pathtree/mergeBDD",
+		[&]() {
+			T = new PathTree_br(header);
+			for (unsigned i = 0; i < paths.size(); i++)
+				T->insert(paths[i], i % 2);
+		},
+		[&]() {T->mergeBDD();},
+		teardown);
+}
+
+static void benchLive(Function * F, BasicBlock * header, const std::vector<ap_var_t> & vars) {
+	Live * LV = NULL;
+	measure("live/queries",
+		[&]() {LV = new Live();},
+		[&]() {
+			for (ap_var_t v : vars)
+				for (Function::iterator b = F->begin(); b != F->end(); ++b)
+					LV->isLiveByLinearityInBlock((Value*)v, b, true);
+		},
+		[&]() {delete LV; LV = NULL;});
+
+	Live Lheader;
+	Node * n = Nodes[header];
+	for (ap_var_t v : vars)
+		n->add_var((Value*)v);
+	measure("environment/construction",
+		nothing,
+		[&]() {Environment env(n, &Lheader);},
+		nothing);
+}
+
+static std::vector<std::string> split(const std::string & s) {
+	std::vector<std::string> res;
+	size_t start = 0;
+	while (start < s.size()) {
+		size_t end = s.find(',', start);
+		if (end == std::string::npos) end = s.size();
+		if (end > start) res.push_back(s.substr(start, end - start));
+		start = end + 1;
+	}
+	return res;
+}
+
+static bool writeResults(const std::string & filename, unsigned nvars, unsigned nbranches) {
+	std::ofstream out(filename.c_str());
+	if (!out.is_open()) {
+		std::cout << "ERROR: cannot open " << filename << "\n";
+		return false;
+	}
+	out << "{\"vars\":" << nvars << ",\"branches\":" << nbranches
+		<< ",\"runs\":" << runs << ",\"benchmarks\":[\n";
+	for (unsigned i = 0; i < results.size(); i++) {
+		const Result & r = results[i];
+		if (i > 0) out << ",\n";
+		out << std::fixed << std::setprecision(0)
+			<< "{\"name\":\"" << r.name << "\""
+			<< ",\"min_ns\":" << r.min()
+			<< ",\"median_ns\":" << r.median()
+			<< ",\"mean_ns\":" << r.mean() << "}";
+	}
+	out << "\n]}\n";
+	return true;
+}
+
+int main(int argc, char ** argv) {
+	po::variables_map opts;
+	po::options_description desc("Options");
+	desc.add_options()
+		("help,h", "Print help messages")
+		("vars", po::value<unsigned>()->default_value(8), "number of variables of the generated loop")
+		("branches", po::value<unsigned>()->default_value(6), "number of if-then-else in the body of the loop")
+		("runs,r", po::value<unsigned>()->default_value(20), "number of runs of each benchmark")
+		("domains,d", po::value<std::string>()->default_value("box,oct,pk,pkeq"), "comma-separated list of abstract domains")
+		("solvers,s", po::value<std::string>()->default_value(
+#ifdef HAS_Z3
+			"z3_api"
+#endif
+#if defined(HAS_Z3) && defined(HAS_YICES)
+			","
+#endif
+#ifdef HAS_YICES
+			"yices_api"
+#endif
+			), "comma-separated list of SMT backends (the SMT-LIB2 solvers need their executable)")
+		("filter,f", po::value<std::string>()->default_value(""), "only run the benchmarks whose name contains this string")
+		("output,o", po::value<std::string>(), "write the results into a JSON file, see scripts/compare_microbench.py")
+		;
+
+	try {
+		po::store(po::parse_command_line(argc, argv, desc), opts);
+		if (opts.count("help")) {
+			std::cout << "Usage: pagai-microbench [options]\n" << desc << "\n";
+			return 0;
+		}
+		po::notify(opts);
+	} catch (std::exception & e) {
+		std::cout << "ERROR\n" << e.what() << "\n" << desc << "\n";
+		return 1;
+	}
+
+	unsigned nvars = std::max(1u, opts["vars"].as<unsigned>());
+	unsigned nbranches = opts["branches"].as<unsigned>();
+	runs = std::max(1u, opts["runs"].as<unsigned>());
+	filter = opts["filter"].as<std::string>();
+
+	std::vector<Apron_Manager_Type> domains;
+	for (const std::string & d : split(opts["domains"].as<std::string>())) {
+		bool error;
+		domains.push_back(ApronManagerFromString(error, d));
+		if (error) {
+			std::cout << "Wrong parameter defining the abstract domain: " << d << "\n";
+			return 1;
+		}
+	}
+
+	Out = &errs();
+	Dbg = &nulls();
+	init_apron();
+
+	LLVMContext C;
+	Module * M = new Module("microbench", C);
+	Function * F = createFunction(M, nvars, nbranches);
+	BasicBlock * header = F->getEntryBlock().getTerminator()->getSuccessor(0);
+	// creates the Nodes of F
+	Pr::getInstance(F);
+
+	std::vector<ap_var_t> vars;
+	for (BasicBlock::iterator it = header->begin(); it != header->end(); ++it) {
+		Instruction * I = it;
+		if (!isa<PHINode>(I)) break;
+		vars.push_back((ap_var_t)I);
+	}
+	Environment env(std::set<ap_var_t>(vars.begin(), vars.end()), std::set<ap_var_t>());
+
+	std::vector<std::pair<std::string, AbstractMan*> > kinds;
+	kinds.push_back(std::make_pair("classic", (AbstractMan*)new AbstractManClassic()));
+	kinds.push_back(std::make_pair("gopan", (AbstractMan*)new AbstractManGopan()));
+	kinds.push_back(std::make_pair("disj", (AbstractMan*)new AbstractManDisj()));
+
+	benchLive(F, header, vars);
+	benchPathTree(header, 12);
+
+	for (auto & k : kinds)
+		for (Apron_Manager_Type D : domains)
+			benchAbstract(k.first, k.second, D, &env, vars);
+
+	for (const std::string & solver : split(opts["solvers"].as<std::string>())) {
+		if (setSolver(solver)) return 1;
+		SMTpass::releaseMemory();
+		for (auto & k : kinds)
+			for (Apron_Manager_Type D : domains)
+				benchSMT(k.first, k.second, D, solver, F, &env, vars);
+	}
+	SMTpass::releaseMemory();
+
+	for (auto & k : kinds)
+		delete k.second;
+
+	if (opts.count("output") && !writeResults(opts["output"].as<std::string>(), nvars, nbranches))
+		return 1;
+	return 0;
+}
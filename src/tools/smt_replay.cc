@@ -0,0 +1,431 @@
+/**
+ * \file smt_replay.cc
+ * \brief pagai-smt-replay: replays a capture written by pagai --smt-capture
+ * \author agent
+ *
+ * Each query of the capture is solved again by the chosen backend, by
+ * several worker threads in parallel. Each worker has its own solver (a child
+ * process for the SMT-LIB2 solvers, a context for z3_api). The tool reports
+ * the distribution of the solving times and the queries whose result differs
+ * from the recorded one.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <boost/program_options.hpp>
+
+#ifdef HAS_Z3
+#   include "z3++.h"
+#endif
+
+#include "../SMTcaptureFormat.h"
+
+namespace po = boost::program_options;
+
+typedef std::chrono::steady_clock Clock;
+typedef std::chrono::duration<double> Duration;
+
+/**
+ * \brief a context record of the capture file: the assertion stack shared
+ * by several queries
+ */
+struct Context {
+	std::string script;
+
+	/**
+	 * \brief declaration lines of the script, which are skipped in the
+	 * scripts of the queries
+	 */
+	std::set<std::string> declarations;
+};
+
+/**
+ * \brief a query record of the capture file, and its replay
+ */
+struct Query {
+	std::string id;
+	std::string context;
+	std::string backend;
+	std::string recorded_result;
+	double recorded_time;
+	std::string script;
+
+	std::string result;
+	double time;
+
+	Query() : recorded_time(0), time(0) {}
+};
+
+/**
+ * \class ReplaySolver
+ * \brief solver used by a worker thread
+ */
+class ReplaySolver {
+	public:
+		virtual ~ReplaySolver() {}
+
+		/**
+		 * \brief solves the script, returns sat, unsat, unknown or error
+		 */
+		virtual std::string check(const std::string & script) = 0;
+};
+
+/**
+ * \class PipeSolver
+ * \brief SMT-LIB2 solver running in a child process, as in SMTlib.cc
+ */
+class PipeSolver : public ReplaySolver {
+
+	private:
+		pid_t pid;
+		FILE * input;
+		FILE * output;
+
+	public:
+		PipeSolver(const std::vector<std::string> & argv) : pid(0), input(NULL), output(NULL) {
+			int rpipefd[2], wpipefd[2];
+			if (pipe(rpipefd) == -1 || pipe(wpipefd) == -1) {
+				perror("pipe");
+				exit(1);
+			}
+			pid = fork();
+			if (pid == -1) {
+				perror("fork");
+				exit(1);
+			}
+			if (pid == 0) {
+				close(wpipefd[1]);
+				close(rpipefd[0]);
+				dup2(wpipefd[0], STDIN_FILENO);
+				dup2(rpipefd[1], STDOUT_FILENO);
+				close(wpipefd[0]);
+				close(rpipefd[1]);
+				std::vector<char*> args;
+				for (const std::string & a : argv)
+					args.push_back(const_cast<char*>(a.c_str()));
+				args.push_back(NULL);
+				execvp(args[0], &args[0]);
+				perror(args[0]);
+				exit(1);
+			}
+			close(wpipefd[0]);
+			close(rpipefd[1]);
+			input = fdopen(rpipefd[0], "r");
+			output = fdopen(wpipefd[1], "w");
+			if (input == NULL || output == NULL) {
+				perror("fdopen");
+				exit(1);
+			}
+		}
+
+		~PipeSolver() {
+			fputs("(exit)\n", output);
+			fclose(output);
+			fclose(input);
+			waitpid(pid, NULL, 0);
+		}
+
+		std::string check(const std::string & script) {
+			// the declarations of the script are removed by the pop
+			fputs("(push 1)\n", output);
+			fputs(script.c_str(), output);
+			fflush(output);
+
+			std::string res = "error";
+			char * line = NULL;
+			size_t size = 0;
+			ssize_t n;
+			while ((n = getline(&line, &size, input)) != -1) {
+				std::string l(line, n);
+				l.erase(l.find_last_not_of(" \r\n\t") + 1);
+				if (l == "sat" || l == "unsat" || l == "unknown") {
+					res = l;
+					break;
+				}
+			}
+			free(line);
+
+			fputs("(pop 1)\n", output);
+			fflush(output);
+			return res;
+		}
+};
+
+#ifdef HAS_Z3
+/**
+ * \class Z3ApiSolver
+ * \brief z3 through its C++ API, as the z3_api backend of pagai
+ */
+class Z3ApiSolver : public ReplaySolver {
+
+	private:
+		z3::context ctx;
+
+	public:
+		std::string check(const std::string & script) {
+			try {
+				z3::expr formula(ctx, Z3_parse_smtlib2_string(ctx, script.c_str(), 0, 0, 0, 0, 0, 0));
+				z3::solver s(ctx);
+				s.add(formula);
+				switch (s.check()) {
+					case z3::sat: return "sat";
+					case z3::unsat: return "unsat";
+					default: return "unknown";
+				}
+			} catch (z3::exception & e) {
+				return "error";
+			}
+		}
+};
+#endif
+
+static ReplaySolver * create_solver(const std::string & solver) {
+#ifdef HAS_Z3
+	if (solver == "z3_api") return new Z3ApiSolver();
+#endif
+	std::vector<std::string> argv;
+	if (solver == "z3") {
+		argv = {"z3", "-smt2", "-in"};
+	} else if (solver == "cvc3") {
+		argv = {"cvc3", "-lang", "smt2"};
+	} else if (solver == "cvc4") {
+		argv = {"cvc4", "--lang", "smt2", "--quiet", "--incremental"};
+	} else if (solver == "mathsat") {
+		argv = {"mathsat"};
+	} else if (solver == "smtinterpol") {
+		argv = {"smtinterpol"};
+	} else {
+		// any other command line reading SMT-LIB2 on its standard input
+		std::istringstream iss(solver);
+		std::string arg;
+		while (iss >> arg) argv.push_back(arg);
+	}
+	return new PipeSolver(argv);
+}
+
+static bool starts_with(const std::string & s, const char * prefix, std::string & rest) {
+	size_t n = strlen(prefix);
+	if (s.compare(0, n, prefix)) return false;
+	rest = s.substr(n);
+	return true;
+}
+
+static bool is_declaration(const std::string & line) {
+	return line.compare(0, 9, "(declare-") == 0;
+}
+
+static bool read_capture(
+		const std::string & filename,
+		std::map<std::string, Context> & contexts,
+		std::vector<Query> & queries) {
+	std::ifstream in(filename.c_str());
+	if (!in.is_open()) {
+		std::cerr << "ERROR: cannot open " << filename << "\n";
+		return false;
+	}
+	std::string line, value;
+	if (!std::getline(in, line) || line != SMT_CAPTURE_HEADER) {
+		std::cerr << "ERROR: " << filename << " is not an SMT capture file\n";
+		return false;
+	}
+	Query * q = NULL;
+	Context * c = NULL;
+	while (std::getline(in, line)) {
+		if (starts_with(line, SMT_CAPTURE_QUERY, value)) {
+			queries.push_back(Query());
+			q = &queries.back();
+			q->id = value;
+			c = NULL;
+		} else if (starts_with(line, SMT_CAPTURE_CONTEXT, value)) {
+			c = &contexts[value];
+			q = NULL;
+		} else if (c != NULL) {
+			if (line == SMT_CAPTURE_END) {
+				c = NULL;
+				continue;
+			}
+			if (is_declaration(line))
+				c->declarations.insert(line);
+			c->script += line;
+			c->script += "\n";
+		} else if (q == NULL) {
+			continue;
+		} else if (starts_with(line, SMT_CAPTURE_IN_CONTEXT, value)) {
+			q->context = value;
+		} else if (starts_with(line, SMT_CAPTURE_BACKEND, value)) {
+			q->backend = value;
+		} else if (starts_with(line, SMT_CAPTURE_RESULT, value)) {
+			q->recorded_result = value;
+		} else if (starts_with(line, SMT_CAPTURE_TIME, value)) {
+			q->recorded_time = atof(value.c_str());
+		} else if (starts_with(line, SMT_CAPTURE_ASSERTIONS, value)
+				|| starts_with(line, SMT_CAPTURE_PIPE_BYTES, value)
+				|| starts_with(line, SMT_CAPTURE_PARSE_TIME, value)) {
+			// not needed for the replay
+		} else if (line == SMT_CAPTURE_END) {
+			q = NULL;
+		} else {
+			q->script += line;
+			q->script += "\n";
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief script checking q: the script of its context, then its own script
+ * without the declarations already made by the context. Empty if the
+ * context is missing from the capture.
+ */
+static std::string full_script(const Query & q, const std::map<std::string, Context> & contexts) {
+	if (q.context.empty()) return q.script;
+	std::map<std::string, Context>::const_iterator c = contexts.find(q.context);
+	if (c == contexts.end()) return "";
+	std::string res = c->second.script;
+	std::istringstream lines(q.script);
+	std::string line;
+	while (std::getline(lines, line)) {
+		if (is_declaration(line) && c->second.declarations.count(line)) continue;
+		res += line;
+		res += "\n";
+	}
+	return res;
+}
+
+static double percentile(const std::vector<double> & sorted, double p) {
+	if (sorted.empty()) return 0;
+	size_t k = (size_t)(p * (sorted.size() - 1) + 0.5);
+	return sorted[k];
+}
+
+static void print_distribution(const std::string & name, std::vector<double> times) {
+	std::sort(times.begin(), times.end());
+	double total = 0;
+	for (double t : times) total += t;
+	std::cout << std::setw(10) << name
+		<< std::fixed << std::setprecision(6)
+		<< " total " << total
+		<< " min " << percentile(times, 0)
+		<< " p50 " << percentile(times, 0.5)
+		<< " p90 " << percentile(times, 0.9)
+		<< " p99 " << percentile(times, 0.99)
+		<< " max " << percentile(times, 1)
+		<< "\n";
+}
+
+int main(int argc, char ** argv) {
+	po::variables_map vm;
+	po::options_description desc("Options");
+	desc.add_options()
+		("input,i", po::value<std::string>()->required(), "capture file written by pagai --smt-capture")
+		("help,h", "Print help messages")
+		("solver,s", po::value<std::string>()->default_value(
+#ifdef HAS_Z3
+			"z3_api"
+#else
+			"z3"
+#endif
+			), "z3_api, z3, cvc3, cvc4, mathsat, smtinterpol, or a command line reading SMT-LIB2 on stdin")
+		("jobs,j", po::value<unsigned>()->default_value(std::max(1u, std::thread::hardware_concurrency())), "number of queries solved in parallel")
+		("csv", "print one line per query: id,recorded_result,result,recorded_time,time")
+		;
+	po::positional_options_description positionalOptions;
+	positionalOptions.add("input", 1);
+
+	try {
+		po::store(po::command_line_parser(argc, argv).options(desc).positional(positionalOptions).run(), vm);
+		if (vm.count("help")) {
+			std::cout << "Usage: pagai-smt-replay [options] capture\n" << desc << "\n";
+			return 0;
+		}
+		po::notify(vm);
+	} catch (std::exception & e) {
+		std::cout << "ERROR\n" << e.what() << "\n" << desc << "\n";
+		return 1;
+	}
+
+	std::map<std::string, Context> contexts;
+	std::vector<Query> queries;
+	if (!read_capture(vm["input"].as<std::string>(), contexts, queries)) return 1;
+
+	std::string solver = vm["solver"].as<std::string>();
+	unsigned jobs = std::max(1u, vm["jobs"].as<unsigned>());
+
+	// each worker takes the next query not yet solved
+	std::atomic<size_t> next(0);
+	std::vector<std::thread> workers;
+	for (unsigned w = 0; w < jobs; w++) {
+		workers.push_back(std::thread([&]() {
+			ReplaySolver * S = create_solver(solver);
+			size_t k;
+			while ((k = next++) < queries.size()) {
+				Query & q = queries[k];
+				if (q.script.empty()) continue;
+				std::string script = full_script(q, contexts);
+				if (script.empty()) {
+					q.script.clear();
+					continue;
+				}
+				Clock::time_point start = Clock::now();
+				q.result = S->check(script);
+				q.time = Duration(Clock::now() - start).count();
+			}
+			delete S;
+		}));
+	}
+	for (std::thread & t : workers) t.join();
+
+	std::vector<double> recorded, replayed;
+	std::map<std::string, int> results;
+	int skipped = 0, mismatches = 0;
+	for (const Query & q : queries) {
+		if (q.script.empty()) {
+			skipped++;
+			continue;
+		}
+		recorded.push_back(q.recorded_time);
+		replayed.push_back(q.time);
+		results[q.result]++;
+		bool decided = (q.result == "sat" || q.result == "unsat")
+			&& (q.recorded_result == "sat" || q.recorded_result == "unsat");
+		if (decided && q.result != q.recorded_result) {
+			mismatches++;
+			std::cout << "MISMATCH query " << q.id << ": recorded "
+				<< q.recorded_result << ", replayed " << q.result << "\n";
+		}
+	}
+
+	if (vm.count("csv")) {
+		std::cout << "id,recorded_result,result,recorded_time,time\n";
+		for (const Query & q : queries) {
+			if (q.script.empty()) continue;
+			std::cout << q.id << "," << q.recorded_result << "," << q.result
+				<< "," << q.recorded_time << "," << q.time << "\n";
+		}
+	}
+
+	std::cout << queries.size() << " queries, " << skipped
+		<< " without formula (not replayed), " << mismatches << " mismatches\n";
+	for (auto & r : results)
+		std::cout << "  " << r.first << ": " << r.second << "\n";
+	print_distribution("recorded", recorded);
+	print_distribution(solver, replayed);
+	return mismatches ? 2 : 0;
+}
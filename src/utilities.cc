@@ -59,4 +59,53 @@ std::string canonize_line(const std::string & line)
 	return canonized.str();
 }
 
+std::string json_escape(const std::string & s)
+{
+	std::string res;
+	for (char c : s) {
+		switch (c) {
+			case '"': res += "\\\""; break;
+			case '\\': res += "\\\\"; break;
+			case '\n': res += "\\n"; break;
+			default:
+				if ((unsigned char)c < 0x20) continue;
+				res += c;
+		}
+	}
+	return res;
+}
+
+void read_make_dependencies(std::istream & in, std::vector<std::string> & deps)
+{
+	std::string token;
+	bool target = true;
+	char c;
+	while (in.get(c)) {
+		if (c == '\\') {
+			char next;
+			if (!in.get(next)) break;
+			// a backslash before a newline continues the rule, before a
+			// space it escapes it
+			if (next == '\r' && in.peek() == '\n') in.get(next);
+			if (next != '\n') {
+				token += next;
+				continue;
+			}
+			c = ' ';
+		}
+		if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+			if (token.empty()) continue;
+			if (target) {
+				if (token[token.size() - 1] == ':') target = false;
+			} else {
+				deps.push_back(token);
+			}
+			token.clear();
+		} else {
+			token += c;
+		}
+	}
+	if (!token.empty() && !target) deps.push_back(token);
+}
+
 } // end namespace utilities
@@ -9,7 +9,9 @@
 #ifndef _UTILITIES_H
 #define _UTILITIES_H
 
+#include <istream>
 #include <string>
+#include <vector>
 
 namespace utilities {
 
@@ -18,6 +20,18 @@ namespace utilities {
  */
 std::string canonize_line(const std::string & line);
 
+/**
+ * \brief Escape a string so that it can be written between quotes in a JSON
+ * file. Control characters other than newlines are dropped.
+ */
+std::string json_escape(const std::string & s);
+
+/**
+ * \brief Read the dependencies listed in a make rule, as written by
+ * clang -MD, and append them to deps.
+ */
+void read_make_dependencies(std::istream & in, std::vector<std::string> & deps);
+
 }
 
 #endif
@@ -365,7 +365,7 @@ int yices::SMT_check(SMT_expr a, std::set<std::string> & true_booleans) {
 	//*Out << "\n";
 	lbool res = yices_check(ctx);
 	if (res == l_undef) {
-		*Out << "undef\n";
+		// printed by SMTpass, once the query is given up
 		return -1;
 	}
 	if (res == l_true) {
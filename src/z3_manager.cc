@@ -6,9 +6,11 @@
 #if HAS_Z3
 
 #include <algorithm>
+#include <climits>
 #include <cstddef>
 #include <cstring>
 #include <sstream>
+#include <vector>
 #include <iostream>
 #include <gmp.h>
 
@@ -136,26 +138,33 @@ SMT_expr z3_manager::SMT_mk_num (int n){
 	return SMT_expr(expr(ctx.int_val(n)));
 }
 
+SMT_expr z3_manager::SMT_mk_num_int64 (int64_t n){
+	return SMT_expr(expr(ctx, Z3_mk_int64(ctx, n, ctx.int_sort())));
+}
+
+/**
+ * \brief mpz_get_str into a buffer that can be reused for several numbers
+ */
+static const char * mpz_to_cstr(mpz_t z, std::vector<char> & buffer) {
+	size_t size = mpz_sizeinbase(z, 10) + 2;
+	if (buffer.size() < size) buffer.resize(size);
+	return mpz_get_str(buffer.data(), 10, z);
+}
+
 SMT_expr z3_manager::SMT_mk_num_mpq (mpq_t mpq) {
-	//char * x = mpq_get_str (NULL,10,mpq);
-	//SMT_expr res(expr(ctx.int_val(x)));
-	//free(x);
-
-	SMT_expr res;
-	char * cnum = mpz_get_str(NULL,10,mpq_numref(mpq));
-	char * cden = mpz_get_str(NULL,10,mpq_denref(mpq));
-	std::string snum(cnum);
-	std::string sden(cden);
-	if (sden.compare("1")) {
-		SMT_expr numerator(expr(ctx.int_val(cnum)));
-		SMT_expr denominator(expr(ctx.int_val(cden)));
-		res = SMT_mk_div(numerator,denominator);
-	} else {
-		res = expr(ctx.int_val(cnum));
+	bool integer = (mpz_cmp_ui(mpq_denref(mpq), 1) == 0);
+	if (mpz_fits_slong_p(mpq_numref(mpq)) && mpz_fits_slong_p(mpq_denref(mpq))) {
+		SMT_expr numerator = SMT_mk_num_int64(mpz_get_si(mpq_numref(mpq)));
+		if (integer) return numerator;
+		return SMT_mk_div(numerator, SMT_mk_num_int64(mpz_get_si(mpq_denref(mpq))));
 	}
-	free(cnum);
-	free(cden);
-	return res;
+
+	// Z3 only reads big numerals from strings
+	std::vector<char> buffer;
+	SMT_expr numerator(expr(ctx.int_val(mpz_to_cstr(mpq_numref(mpq), buffer))));
+	if (integer) return numerator;
+	SMT_expr denominator(expr(ctx.int_val(mpz_to_cstr(mpq_denref(mpq), buffer))));
+	return SMT_mk_div(numerator,denominator);
 }
 
 SMT_expr z3_manager::SMT_mk_real (double x) {
@@ -299,6 +308,16 @@ void z3_manager::SMT_assert(SMT_expr a){
 	s->add(*a.expr());
 }
 
+std::string z3_manager::SMT_to_smtlib2(SMT_expr a) {
+	Z3_set_ast_print_mode(ctx,Z3_PRINT_SMTLIB2_COMPLIANT);
+	std::string res = Z3_benchmark_to_smtlib_string(ctx, "pagai", "", "unknown", "", 0, NULL, *a.expr());
+	// the benchmark ends with a check-sat command, the caller adds its own
+	size_t pos = res.rfind("(check-sat)");
+	if (pos != std::string::npos)
+		res.erase(pos);
+	return res;
+}
+
 int z3_manager::SMT_check(SMT_expr a, std::set<std::string> & true_booleans){
 	int ret = 0;
 	SMT_assert(a);
@@ -320,7 +339,7 @@ int z3_manager::SMT_check(SMT_expr a, std::set<std::string> & true_booleans){
 			DEBUG(
 					*Out << "unknown\n";
 				 );
-			*Out << "UNKNOWN\n";
+			// printed by SMTpass, once the query is given up
 			ret = -1;
 			break;
 		case sat:
@@ -387,4 +406,28 @@ bool z3_manager::interrupt() {
 	Z3_interrupt(ctx);
 	return true;
 }
+
+bool z3_manager::set_timeout(unsigned ms) {
+	unsigned limit = (getTimeout() != 0) ? getTimeout()*1000 : UINT_MAX;
+	if (ms != 0 && ms < limit)
+		limit = ms;
+	try {
+		params p(ctx);
+		p.set("timeout", limit);
+		s->set(p);
+	} catch (z3::exception e) {
+		return false;
+	}
+	return true;
+}
+
+size_t z3_manager::memory_usage() {
+	// the statistics of the solver give the memory of the process, in MB
+	z3::stats st = s->statistics();
+	for (unsigned i = 0; i < st.size(); i++) {
+		if (st.key(i) == "memory" && st.is_double(i))
+			return (size_t)(st.double_value(i) * 1024 * 1024);
+	}
+	return 0;
+}
 #endif
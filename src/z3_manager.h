@@ -55,6 +55,7 @@ class z3_manager: public SMT_manager {
 
 		SMT_expr SMT_mk_num (int n);
 		SMT_expr SMT_mk_num_mpq (mpq_t mpq);
+		SMT_expr SMT_mk_num_int64 (int64_t n);
 		SMT_expr SMT_mk_real (double x);
 
 		SMT_expr SMT_mk_sum (std::vector<SMT_expr> args);
@@ -88,8 +89,11 @@ class z3_manager: public SMT_manager {
 		void SMT_print(SMT_expr a);
 		void SMT_assert(SMT_expr a);
 		int SMT_check(SMT_expr a, std::set<std::string> & true_booleans);
+		std::string SMT_to_smtlib2(SMT_expr a);
 
 		bool interrupt();
+		bool set_timeout(unsigned ms);
+		size_t memory_usage();
 };
 #endif
 #endif
@@ -0,0 +1,36 @@
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#include "utilities.h"
+
+void test(const std::string & rule, const std::vector<std::string> & deps_exp)
+{
+    std::istringstream in(rule);
+    std::vector<std::string> deps_out;
+    utilities::read_make_dependencies(in, deps_out);
+    if (deps_out != deps_exp) {
+        std::cerr << "rule: \"" << rule << "\"" << std::endl << "output:";
+        for (const std::string & d : deps_out) std::cerr << " \"" << d << "\"";
+        std::cerr << std::endl << "expected:";
+        for (const std::string & d : deps_exp) std::cerr << " \"" << d << "\"";
+        std::cerr << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+int main()
+{
+    test("", {}); // empty file
+    test("a.o:\n", {}); // no dependency
+    test("a.o: a.c\n", {"a.c"}); // single dependency
+    test("a.o: a.c", {"a.c"}); // no newline at the end of the file
+    test("a.o: a.c b.h /usr/include/c.h\n", {"a.c", "b.h", "/usr/include/c.h"}); // several dependencies
+    test("a.o: a.c \\\n  b.h \\\n  c.h\n", {"a.c", "b.h", "c.h"}); // rule continued on several lines (as written by clang)
+    test("a.o: a.c \\\r\n  b.h\r\n", {"a.c", "b.h"}); // CRLF line endings
+    test("a.o: dir\\ with\\ spaces/b.h\n", {"dir with spaces/b.h"}); // escaped spaces
+    test("a.o a.d: a.c\n", {"a.c"}); // several targets
+    test("a.o:\ta.c\tb.h\n", {"a.c", "b.h"}); // tabs as separators
+
+    return EXIT_SUCCESS;
+}
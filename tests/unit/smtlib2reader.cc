@@ -0,0 +1,140 @@
+#include <cstdlib>
+#include <iostream>
+
+#include <unistd.h>
+
+#include "SMTlib2reader.h"
+
+// the reader prints the error messages of the solver into Out, and times
+// its parsing with time_now: both are defined in the rest of pagai
+std::string messages;
+llvm::raw_string_ostream messages_stream(messages);
+llvm::raw_ostream * Out = &messages_stream;
+
+TimePoint time_now()
+{
+    return Clock::now();
+}
+
+void fail(const std::string & reply, const std::string & message)
+{
+    std::cerr << "reply: \"" << reply << "\" | " << message << std::endl;
+    std::exit(EXIT_FAILURE);
+}
+
+// file descriptor from which the reader reads reply
+int pipe_of(const std::string & reply)
+{
+    int fds[2];
+    if (pipe(fds) != 0 || write(fds[1], reply.data(), reply.size()) != (ssize_t)reply.size()) {
+        std::cerr << "cannot create the pipe" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    close(fds[1]);
+    return fds[0];
+}
+
+void check_messages(const std::string & reply, const std::string & messages_exp)
+{
+    if (messages_stream.str() != messages_exp) {
+        fail(reply, "messages: \"" + messages_stream.str() + "\" | expected: \"" + messages_exp + "\"");
+    }
+    messages.clear();
+}
+
+void test_answers(const std::string & reply, const std::vector<SMTans> & answers_exp,
+        const std::string & messages_exp = "")
+{
+    int fd = pipe_of(reply);
+    SMTlib2reader reader(fd);
+    for (SMTans exp : answers_exp) {
+        SMTans ans = reader.readAnswer();
+        if (ans != exp) {
+            fail(reply, "answer: " + std::to_string(ans) + " | expected: " + std::to_string(exp));
+        }
+    }
+    close(fd);
+    check_messages(reply, messages_exp);
+}
+
+void test_values(const std::string & reply, bool ok_exp, const std::vector<std::string> & true_exp,
+        const std::string & messages_exp = "")
+{
+    int fd = pipe_of(reply);
+    SMTlib2reader reader(fd);
+    std::vector<unsigned> true_ids;
+    bool ok = reader.readTrueValues(true_ids);
+    close(fd);
+    if (ok != ok_exp) {
+        fail(reply, ok ? "read, expected an error" : "error, expected the values");
+    }
+    if (ok) {
+        std::vector<std::string> true_names;
+        for (unsigned id : true_ids) true_names.push_back(reader.getName(id).str());
+        if (true_names != true_exp) {
+            std::string names;
+            for (const std::string & n : true_names) names += " \"" + n + "\"";
+            fail(reply, "true symbols:" + names);
+        }
+        // the ids are the ones of the interned symbols
+        for (size_t k = 0; k < true_ids.size(); k++) {
+            if (reader.intern(true_exp[k]) != true_ids[k]) fail(reply, "wrong id for " + true_exp[k]);
+        }
+    }
+    check_messages(reply, messages_exp);
+}
+
+// a malformed get-value reply is read up to its end, so that the next
+// reply is read correctly
+void test_resync(const std::string & reply, SMTans next_exp)
+{
+    int fd = pipe_of(reply);
+    SMTlib2reader reader(fd);
+    std::vector<unsigned> true_ids;
+    bool ok = reader.readTrueValues(true_ids);
+    SMTans next = reader.readAnswer();
+    close(fd);
+    if (ok) fail(reply, "read, expected an error");
+    if (next != next_exp) {
+        fail(reply, "next answer: " + std::to_string(next) + " | expected: " + std::to_string(next_exp));
+    }
+    check_messages(reply, "");
+}
+
+int main()
+{
+    // check-sat
+    test_answers("sat\n", {SAT});
+    test_answers("unsat\n", {UNSAT});
+    test_answers("unknown\n", {UNKNOWN});
+    test_answers("success\nsuccess\nsat\n", {SAT}); // replies of the declarations and assertions
+    test_answers("sat\nunsat\nunknown\n", {SAT, UNSAT, UNKNOWN}); // several queries on the same pipe
+    test_answers("  ; comment\n\tunsat", {UNSAT}); // comment, no newline at the end
+    test_answers("", {ERROR}); // solver died
+    test_answers("timeout\n", {ERROR}, "unexpected reply of the SMT solver: timeout\n");
+    test_answers("(error \"line 3 column 10: unknown constant x\")\nsat\n", {ERROR, SAT},
+            "line 3 column 10: unknown constant x\n");
+    test_answers("(error \"the \"\"quoted\"\" word\")\n", {ERROR}, "the \"quoted\" word\n"); // SMT-lib 2.5 escape
+    test_answers("(error \"a (parenthesis\")\nunsat\n", {ERROR, UNSAT}, "a (parenthesis\n");
+
+    // get-value
+    test_values("((b1 true) (b2 false) (b3 true))\n", true, {"b1", "b3"});
+    test_values("()\n", true, {});
+    test_values("((|x y| true) (|x| false) (|(z)| true))\n", true, {"x y", "(z)"});
+    test_values("((x (- 1)) ((- x 1) 3) (y (/ 1 2)) ((+ (* 2 x) (- y)) (/ (- 1) 2)) (b true))\n",
+            true, {"b"}); // nested terms and values
+    test_values("((b1 true)\n (b2 true)) ; comment\n", true, {"b1", "b2"});
+    test_values("(error \"model is not available\")\n", false, {}, "model is not available\n");
+    test_values("((b1 true) (b2\n", false, {}); // truncated reply
+    test_values("unsat\n", false, {});
+
+    // malformed get-value replies
+    test_resync("((b1 true) \"b2\" (b3 true))\nsat\n", SAT); // string instead of a pair
+    test_resync("((b1 true) (\"b2\" true) (b3 true))\nunsat\n", UNSAT); // string as a term
+    test_resync("((b1 true) (b2 \"true\") (b3 true))\nsat\n", SAT); // string as a value
+    test_resync("((b1 true) (b2 true (x y)) (b3 true))\nunknown\n", UNKNOWN); // extra term in a pair
+    test_resync("((b1 true) (b2) (b3 true))\nsat\n", SAT); // missing value
+    test_resync("((b1 true) ())\nunsat\n", UNSAT); // empty pair
+
+    return EXIT_SUCCESS;
+}